@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   BenchmarkSuite.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Runs named benchmarks and reports their timings as JSON
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkSuite.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+
+#include "State.hpp"
+#include "AllocationTracker.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Runs a batch of iterations, returning the nanoseconds it took
+///////////////////////////////////////////////////////////////////////////////
+static double runBatch(const BenchmarkSuite::Iteration& iteration,
+                       sf::Uint64 size)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (sf::Uint64 i = 0; i < size; ++i) {
+        iteration();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // The profiler's zones are collected between batches, so that its rings
+    // don't fill up and drop zones as they never do in the game
+    State::get().profiler.endFrame(sf::microseconds(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            end - begin).count()));
+
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - begin).count());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BenchmarkSuite::add(const std::string& name, Setup setup)
+{
+    m_entries.push_back({name, std::move(setup)});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 BenchmarkSuite::run(const std::string& filter, sf::Time sampleTime)
+{
+    m_results.clear();
+
+    for (const auto& entry : m_entries) {
+        if (entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        m_results.push_back(measure(entry, sampleTime));
+
+        const auto& result = m_results.back();
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-40s %12.0f ns %10llu iterations",
+                      result.name.c_str(), result.median,
+                      static_cast<unsigned long long>(result.iterations));
+        std::cerr << line << std::endl;
+    }
+
+    return static_cast<sf::Uint32>(m_results.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<BenchmarkSuite::Result>& BenchmarkSuite::getResults() const
+{
+    return m_results;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BenchmarkSuite::writeJson(std::ostream& stream, bool headless) const
+{
+    stream << "{\n"
+           << "  \"version\": 2,\n"
+           << "  \"headless\": " << (headless ? "true" : "false") << ",\n"
+           << "  \"allocationsTracked\": "
+           << (AllocationTracker::Enabled ? "true" : "false") << ",\n"
+           << "  \"benchmarks\": [";
+
+    auto separator = "\n";
+    for (const auto& result : m_results) {
+        char line[640];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"iterations\": %llu, "
+                      "\"minNs\": %.1f, \"medianNs\": %.1f, "
+                      "\"meanNs\": %.1f, \"p95Ns\": %.1f, "
+                      "\"allocations\": %.3f, \"bytes\": %.1f, "
+                      "\"drawCalls\": %.3f, \"vertices\": %.1f, "
+                      "\"textureSwitches\": %.3f, "
+                      "\"targetSwitches\": %.3f}",
+                      result.name.c_str(),
+                      static_cast<unsigned long long>(result.iterations),
+                      result.minimum, result.median, result.mean, result.p95,
+                      result.allocations, result.bytes, result.drawCalls,
+                      result.vertices, result.textureSwitches,
+                      result.targetSwitches);
+        stream << separator << line;
+        separator = ",\n";
+    }
+
+    stream << "\n  ]\n}\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BenchmarkSuite::Result BenchmarkSuite::measure(const Entry& entry,
+                                               sf::Time sampleTime)
+{
+    auto iteration = entry.setup();
+    auto target = static_cast<double>(sampleTime.asMicroseconds()) * 1000.0;
+
+    sf::Uint64 batch = 1;
+    while (runBatch(iteration, batch) < target && batch < MaxBatch) {
+        batch *= 2;
+    }
+
+    std::vector<double> samples;
+    auto before = AllocationTracker::getTotalCounts();
+    auto drawsBefore = State::get().renderStats.getTotalCounts();
+
+    for (sf::Uint32 i = 0; i < SampleCount; ++i) {
+        samples.push_back(runBatch(iteration, batch) /
+                          static_cast<double>(batch));
+    }
+
+    auto after = AllocationTracker::getTotalCounts();
+    auto drawsAfter = State::get().renderStats.getTotalCounts();
+    auto iterations = batch * SampleCount;
+
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (auto sample : samples) {
+        sum += sample;
+    }
+
+    auto perIteration = [iterations](sf::Uint64 before, sf::Uint64 after) {
+        return static_cast<double>(after - before) /
+               static_cast<double>(iterations);
+    };
+
+    return {entry.name, iterations, samples.front(),
+            samples[samples.size() / 2],
+            sum / static_cast<double>(samples.size()),
+            samples[(samples.size() * 95 - 1) / 100],
+            perIteration(before.allocations, after.allocations),
+            perIteration(before.bytes, after.bytes),
+            perIteration(drawsBefore.drawCalls, drawsAfter.drawCalls),
+            perIteration(drawsBefore.vertices, drawsAfter.vertices),
+            perIteration(drawsBefore.textureSwitches,
+                         drawsAfter.textureSwitches),
+            perIteration(drawsBefore.targetSwitches,
+                         drawsAfter.targetSwitches)};
+}
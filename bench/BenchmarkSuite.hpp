@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   BenchmarkSuite.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Runs named benchmarks and reports their timings as JSON
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__BENCHMARK_SUITE_HPP
+#define ROGUELIKE__BENCHMARK_SUITE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Runs named benchmarks and reports their timings as JSON
+///
+/// A benchmark is a setup function, which builds whatever the benchmark
+/// needs and returns a function running one iteration of it. Setups only
+/// run for the benchmarks which are selected, so expensive fixtures cost
+/// nothing when filtered out.
+///
+/// Each benchmark first runs batches of doubling size until a batch takes
+/// the sample time, which also warms it up, and then times SampleCount
+/// batches of that size. Times are reported per iteration, so they don't
+/// depend on the batch size.
+///////////////////////////////////////////////////////////////////////////////
+class BenchmarkSuite {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of batches timed per benchmark
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 SampleCount = 30;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Largest batch, for iterations too quick to time on their own
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint64 MaxBatch = 1 << 24;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs a single iteration of a benchmark
+    ///////////////////////////////////////////////////////////////////////////
+    typedef std::function<void()> Iteration;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Prepares a benchmark, returning its iteration
+    ///////////////////////////////////////////////////////////////////////////
+    typedef std::function<Iteration()> Setup;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Timings of a benchmark
+    ///
+    /// Times are in nanoseconds per iteration, over the timed batches.
+    /// Allocations and draws are per iteration, and allocations are only
+    /// counted when allocations are tracked.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Result {
+        std::string name;
+        sf::Uint64 iterations;
+        double minimum;
+        double median;
+        double mean;
+        double p95;
+        double allocations;
+        double bytes;
+        double drawCalls;
+        double vertices;
+        double textureSwitches;
+        double targetSwitches;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    BenchmarkSuite() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    BenchmarkSuite(const BenchmarkSuite&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const BenchmarkSuite&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a benchmark
+    ///
+    /// Benchmarks run and are reported in the order they are added.
+    ///
+    /// @param name     Name of the benchmark, which is written to the JSON
+    ///                 as is, so must not need escaping
+    /// @param setup    Prepares the benchmark
+    ///////////////////////////////////////////////////////////////////////////
+    void add(const std::string& name, Setup setup);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs the benchmarks whose names contain a filter
+    ///
+    /// Each benchmark's median is written to std::cerr as it finishes.
+    ///
+    /// @param filter       Text the names must contain, empty for all
+    /// @param sampleTime   Time each timed batch should take at least
+    ///
+    /// @return Number of benchmarks run
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 run(const std::string& filter, sf::Time sampleTime);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the results of the benchmarks which have run
+    ///
+    /// @return Results in the order the benchmarks were added
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<Result>& getResults() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the results as JSON
+    ///
+    /// The keys are always written in the same order, with the same
+    /// precision, so that results can be diffed and compared by tools.
+    ///
+    /// @param stream   Stream to write to
+    /// @param headless Whether the benchmarks ran without a GL context
+    ///////////////////////////////////////////////////////////////////////////
+    void writeJson(std::ostream& stream, bool headless) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A benchmark which has been added
+    ///////////////////////////////////////////////////////////////////////////
+    struct Entry {
+        std::string name;
+        Setup setup;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs a benchmark
+    ///
+    /// @param entry        The benchmark
+    /// @param sampleTime   Time each timed batch should take at least
+    ///
+    /// @return Its timings
+    ///////////////////////////////////////////////////////////////////////////
+    static Result measure(const Entry& entry, sf::Time sampleTime);
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<Entry> m_entries;
+    std::vector<Result> m_results;
+};
+
+#endif
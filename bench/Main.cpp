@@ -0,0 +1,396 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Main.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Entry point of the benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <SFML/Window.hpp>
+
+#include "Zone.hpp"
+#include "State.hpp"
+#include "Common.hpp"
+#include "MessageLog.hpp"
+#include "GlyphTileMap.hpp"
+#include "WindowManager.hpp"
+#include "BenchmarkSuite.hpp"
+#include "MessageLogWindow.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Size of the frame the benchmarks run in, as the game's
+///////////////////////////////////////////////////////////////////////////////
+static const sf::Vector2u frameSize(896, 504);
+
+///////////////////////////////////////////////////////////////////////////////
+/// Returns a map the size of the frame in text tiles, filled with a pattern
+///////////////////////////////////////////////////////////////////////////////
+static std::shared_ptr<GlyphTileMap> createTileMap()
+{
+    auto map = std::make_shared<GlyphTileMap>(
+        State::get().font, sf::Vector2u(112, 28), sf::Vector2u(8, 18), 16);
+
+    auto area = map->getArea();
+    for (sf::Uint32 x = 0; x < area.x; ++x) {
+        for (sf::Uint32 y = 0; y < area.y; ++y) {
+            map->setTile({x, y}, GlyphTileMap::Tile(
+                static_cast<sf::Uint32>('a' + (x + y) % 26),
+                GlyphTileMap::Tile::Center, sf::Color(200, 200, 200),
+                sf::Color(20, 20, 20)));
+        }
+    }
+
+    return map;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Adds the benchmarks of setting, animating and building the vertices of
+/// GlyphTileMap tiles
+///////////////////////////////////////////////////////////////////////////////
+static void addGlyphTileMapBenchmarks(BenchmarkSuite& suite)
+{
+    // Tiles are set to alternate values, so every call changes the tile
+    suite.add("GlyphTileMap::setTile", [] {
+        auto map = createTileMap();
+        auto count = map->getArea().x * map->getArea().y;
+        auto index = std::make_shared<sf::Uint32>(0);
+
+        GlyphTileMap::Tile tiles[2] = {
+            {'#', GlyphTileMap::Tile::Center, sf::Color(120, 120, 120),
+             sf::Color(40, 40, 40)},
+            {'.', GlyphTileMap::Tile::Floor, sf::Color(90, 60, 30),
+             sf::Color(30, 20, 10)}
+        };
+
+        return [map, count, index, tiles] {
+            auto i = (*index)++;
+            auto width = map->getArea().x;
+            map->setTile({i % width, (i % count) / width},
+                         tiles[(i / count) % 2]);
+        };
+    });
+
+    suite.add("GlyphTileMap::setTileFgColor", [] {
+        auto map = createTileMap();
+        auto count = map->getArea().x * map->getArea().y;
+        auto index = std::make_shared<sf::Uint32>(0);
+
+        return [map, count, index] {
+            auto i = (*index)++;
+            auto shade = static_cast<sf::Uint8>(i);
+            map->setTileFgColor(
+                {i % map->getArea().x, (i % count) / map->getArea().x},
+                sf::Color(shade, shade, shade));
+        };
+    });
+
+    // One tile in ten flickers, as torch lit tiles do
+    suite.add("GlyphTileMap::update/animated 10%", [] {
+        auto map = createTileMap();
+        auto area = map->getArea();
+
+        for (sf::Uint32 i = 0; i < area.x * area.y; i += 10) {
+            map->setTileAnimation({i % area.x, i / area.x},
+                [](GlyphTileMap::Tile& tile, sf::Int32 deltaMs) {
+                    tile.foreground.r = static_cast<sf::Uint8>(
+                        tile.foreground.r + deltaMs);
+                });
+        }
+
+        return [map] {
+            map->update();
+        };
+    });
+
+    suite.add("GlyphTileMap::appendVertices", [] {
+        auto map = createTileMap();
+        auto vertices = std::make_shared<std::vector<sf::Vertex>>();
+
+        return [map, vertices] {
+            vertices->clear();
+            map->appendVertices(*vertices, sf::Transform::Identity);
+        };
+    });
+
+    // Regions as Zone redraws them, one per dirty tile
+    suite.add("GlyphTileMap::appendRegion/10%", [] {
+        auto map = createTileMap();
+        auto regions = std::make_shared<std::vector<sf::FloatRect>>();
+        auto vertices = std::make_shared<std::vector<sf::Vertex>>();
+
+        auto spacing = sf::Vector2f(map->getSpacing());
+        auto overhang = static_cast<float>(map->getOverhang());
+        auto width = map->getArea().x;
+        for (sf::Uint32 i = 0; i < width * map->getArea().y; i += 10) {
+            regions->emplace_back(
+                static_cast<float>(i % width) * spacing.x - overhang,
+                static_cast<float>(i / width) * spacing.y - overhang,
+                spacing.x + overhang * 2.f, spacing.y + overhang * 2.f);
+        }
+
+        return [map, regions, vertices] {
+            vertices->clear();
+            for (const auto& region : *regions) {
+                map->appendRegion(region, *vertices);
+            }
+        };
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Adds the benchmarks of generating a zone and of running its turns
+///////////////////////////////////////////////////////////////////////////////
+static void addZoneBenchmarks(BenchmarkSuite& suite)
+{
+    // Each zone is generated from the same seed, so does the same work
+    suite.add("Zone::Zone", [] {
+        return [] {
+            State::get().random.seed(1);
+            Zone zone;
+        };
+    });
+
+    // Actors are packed onto the floor of the 50x50 zone, several to a
+    // tile, so most of them are blocked, but they all still take turns
+    suite.add("Zone::update/rest 1000 turns, 10k actors", [] {
+        State::get().random.seed(1);
+        auto zone = std::make_shared<Zone>();
+
+        auto& random = State::get().random;
+        for (sf::Uint32 i = 0; i < 10000;) {
+            sf::Vector2u coord(random.below(50), random.below(50));
+            if (!zone->getTerrain(coord).opaque) {
+                zone->spawn(coord, Glyph{'r', sf::Color(150, 110, 90)},
+                            Actor{random.below(60) + 70}, Brain());
+                ++i;
+            }
+        }
+
+        return [zone] {
+            zone->rest(1000);
+            zone->update();
+        };
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Adds the benchmarks of updating a window manager with a number of windows
+///////////////////////////////////////////////////////////////////////////////
+static void addWindowManagerBenchmarks(BenchmarkSuite& suite)
+{
+    // The windows are tiled across the frame, each showing the same log
+    auto setup = [](sf::Uint32 windowCount, bool messages) {
+        return [windowCount, messages] {
+            auto log = std::make_shared<MessageLog>(40);
+            auto manager = std::make_shared<WindowManager>();
+
+            for (sf::Uint32 i = 0; i < windowCount; ++i) {
+                auto window = new MessageLogWindow(
+                    "bench" + std::to_string(i), *log, 4);
+                window->setPosition(
+                    static_cast<float>((i % 2) * frameSize.x / 2),
+                    static_cast<float>((i / 2) * 8 % frameSize.y));
+                manager->addWindow(window);
+            }
+
+            return BenchmarkSuite::Iteration([log, manager, messages] {
+                if (messages) {
+                    log->push("The rat bites you.", sf::Color::Red);
+                }
+                manager->update();
+            });
+        };
+    };
+
+    for (sf::Uint32 count : {1u, 8u, 32u}) {
+        suite.add("WindowManager::update/" + std::to_string(count) +
+                  " windows", setup(count, false));
+    }
+    suite.add("WindowManager::update/8 windows, new messages",
+              setup(8, true));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Adds the benchmarks of drawing, whose draws are counted as well
+///////////////////////////////////////////////////////////////////////////////
+static void addDrawBenchmarks(BenchmarkSuite& suite)
+{
+    // Nothing may be drawn without a GL context
+    if (State::get().headless) {
+        return;
+    }
+
+    suite.add("GlyphTileMap::draw", [] {
+        auto map = createTileMap();
+        auto target = std::make_shared<sf::RenderTexture>();
+        target->create(frameSize.x, frameSize.y);
+
+        return [map, target] {
+            target->draw(*map);
+        };
+    });
+
+    // The windows are tiled across the frame, as when updating them
+    auto setup = [](sf::Uint32 windowCount) {
+        return [windowCount] {
+            auto log = std::make_shared<MessageLog>(40);
+            auto manager = std::make_shared<WindowManager>();
+            auto target = std::make_shared<sf::RenderTexture>();
+            target->create(frameSize.x, frameSize.y);
+
+            for (sf::Uint32 i = 0; i < windowCount; ++i) {
+                auto window = new MessageLogWindow(
+                    "bench" + std::to_string(i), *log, 4);
+                window->setPosition(
+                    static_cast<float>((i % 2) * frameSize.x / 2),
+                    static_cast<float>((i / 2) * 8 % frameSize.y));
+                manager->addWindow(window);
+            }
+            manager->update();
+
+            return BenchmarkSuite::Iteration([log, manager, target] {
+                target->draw(*manager);
+            });
+        };
+    };
+
+    for (sf::Uint32 count : {8u, 32u}) {
+        suite.add("WindowManager::draw/" + std::to_string(count) +
+                  " windows", setup(count));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Adds the benchmarks of processing the input of a frame
+///////////////////////////////////////////////////////////////////////////////
+static void addInputBenchmarks(BenchmarkSuite& suite)
+{
+    // A busy frame's worth of input
+    suite.add("State::handleEvent/8 events", [] {
+        auto events = std::make_shared<std::vector<sf::Event>>();
+
+        sf::Event event;
+        for (auto type : {sf::Event::KeyPressed, sf::Event::KeyReleased}) {
+            for (auto code : {sf::Keyboard::H, sf::Keyboard::L}) {
+                event.type = type;
+                event.key = {code, false, false, false, false};
+                events->push_back(event);
+            }
+        }
+        for (auto type : {sf::Event::MouseButtonPressed,
+                          sf::Event::MouseButtonReleased}) {
+            event.type = type;
+            event.mouseButton = {sf::Mouse::Left, 100, 100};
+            events->push_back(event);
+        }
+        event.type = sf::Event::MouseWheelScrolled;
+        event.mouseWheelScroll = {sf::Mouse::VerticalWheel, 1.f, 100, 100};
+        events->push_back(event);
+        events->push_back(event);
+
+        return [events] {
+            for (const auto& event : *events) {
+                State::get().handleEvent(event);
+            }
+            State::get().clearFrameInput();
+        };
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Main
+///
+/// Options:
+///     --filter <text>     Only run the benchmarks whose names contain text
+///     --output <path>     Write the JSON results to a file, not stdout
+///     --sample-ms <n>     Time each timed batch for at least n ms
+///     --headless          Run without a GL context, so without looking up
+///                         glyphs or rendering anything
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string outputPath;
+    sf::Int32 sampleMs = 10;
+    bool headless = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option(argv[i]);
+
+        if (option == "--headless") {
+            headless = true;
+            continue;
+        }
+
+        if (++i >= argc) {
+            log_exit("Missing value for option: " + option);
+        }
+
+        std::string value(argv[i]);
+
+        if (option == "--filter") {
+            filter = value;
+        }
+        else if (option == "--output") {
+            outputPath = value;
+        }
+        else if (option == "--sample-ms") {
+            char* end = nullptr;
+            auto ms = std::strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || ms <= 0 || ms > 60000) {
+                log_exit("Invalid sample time: " + value);
+            }
+            sampleMs = static_cast<sf::Int32>(ms);
+        }
+        else {
+            log_exit("Unknown option: " + option);
+        }
+    }
+
+    // Glyphs and render textures need a GL context, which there is no
+    // window to provide
+    std::unique_ptr<sf::Context> context;
+    if (!headless) {
+        context = std::make_unique<sf::Context>();
+    }
+
+    Profiler::setThreadName("Main");
+    State::get().headless = headless;
+    State::get().deterministic = true;
+    State::get().deltaMs = 16;
+    State::get().frameSize = frameSize;
+    State::get().frameScale = {1.f, 1.f};
+    State::get().frameCompositor.create(frameSize);
+
+    BenchmarkSuite suite;
+    addGlyphTileMapBenchmarks(suite);
+    addZoneBenchmarks(suite);
+    addWindowManagerBenchmarks(suite);
+    addDrawBenchmarks(suite);
+    addInputBenchmarks(suite);
+
+    if (!suite.run(filter, sf::milliseconds(sampleMs))) {
+        log_exit("No benchmarks match: " + filter);
+    }
+
+    if (outputPath.empty()) {
+        suite.writeJson(std::cout, headless);
+    }
+    else {
+        std::ofstream file(outputPath);
+        suite.writeJson(file, headless);
+        if (!file) {
+            log_exit("Could not write results: " + outputPath);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
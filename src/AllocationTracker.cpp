@@ -0,0 +1,253 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   AllocationTracker.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Counts of the heap allocations made through operator new
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+/// The counts on every thread and on each thread, and how many scopes leave
+/// each thread's allocations uncounted. All of them are initialized before
+/// any code runs, so they can be used by allocations made before main().
+///////////////////////////////////////////////////////////////////////////////
+static std::atomic<sf::Uint64> totalAllocations(0);
+static std::atomic<sf::Uint64> totalBytes(0);
+static std::atomic<sf::Int64> liveBytes(0);
+static thread_local AllocationTracker::Counts threadCounts = {0, 0};
+static thread_local sf::Uint32 untrackedDepth = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+AllocationTracker::Untracked::Untracked()
+{
+    ++untrackedDepth;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+AllocationTracker::Untracked::~Untracked()
+{
+    --untrackedDepth;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+AllocationTracker::Counts AllocationTracker::getTotalCounts()
+{
+    return {totalAllocations.load(std::memory_order_relaxed),
+            totalBytes.load(std::memory_order_relaxed)};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+AllocationTracker::Counts AllocationTracker::getThreadCounts()
+{
+    return threadCounts;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Int64 AllocationTracker::getLiveBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+#ifdef ROGUELIKE_TRACK_ALLOCATIONS
+
+///////////////////////////////////////////////////////////////////////////////
+/// Each block is preceded by a header holding its size, for live memory, and
+/// its offset from the start of the memory allocated for it, as aligned
+/// blocks may be offset further than the header
+///////////////////////////////////////////////////////////////////////////////
+struct BlockHeader {
+    std::size_t size;
+    std::size_t offset;
+};
+
+static constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+static_assert(sizeof(BlockHeader) <= HeaderSize,
+              "Block headers must fit before default aligned blocks");
+
+///////////////////////////////////////////////////////////////////////////////
+static void* allocateBlock(std::size_t size, std::size_t alignment) noexcept
+{
+    // malloc() aligns to HeaderSize, so the block is at most the alignment
+    // past the start of the memory, which leaves room for the header
+    auto padding = std::max(alignment, HeaderSize);
+    if (size > SIZE_MAX - padding) {
+        return nullptr;
+    }
+
+    auto memory = static_cast<char*>(std::malloc(size + padding));
+    if (!memory) {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<std::uintptr_t>(memory) + HeaderSize;
+    address = (address + alignment - 1) & ~(alignment - 1);
+    auto block = reinterpret_cast<char*>(address);
+
+    new (block - sizeof(BlockHeader)) BlockHeader{
+        size, static_cast<std::size_t>(block - memory)};
+
+    if (!untrackedDepth) {
+        ++threadCounts.allocations;
+        threadCounts.bytes += size;
+        totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        totalBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    liveBytes.fetch_add(static_cast<sf::Int64>(size),
+                        std::memory_order_relaxed);
+
+    return block;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void* allocateBlockOrThrow(std::size_t size, std::size_t alignment)
+{
+    // As the default operator new does, the new handler is given the chance
+    // to free memory until it gives up
+    for (;;) {
+        if (auto block = allocateBlock(size, alignment)) {
+            return block;
+        }
+
+        auto handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+static void freeBlock(void* block) noexcept
+{
+    if (!block) {
+        return;
+    }
+
+    auto start = static_cast<char*>(block);
+    auto header = reinterpret_cast<BlockHeader*>(start - sizeof(BlockHeader));
+
+    liveBytes.fetch_sub(static_cast<sf::Int64>(header->size),
+                        std::memory_order_relaxed);
+    std::free(start - header->offset);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Replacements of every global operator new and delete
+///////////////////////////////////////////////////////////////////////////////
+
+void* operator new(std::size_t size)
+{
+    return allocateBlockOrThrow(size, HeaderSize);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateBlockOrThrow(size, HeaderSize);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateBlock(size, HeaderSize);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateBlock(size, HeaderSize);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateBlockOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateBlockOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept
+{
+    return allocateBlock(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept
+{
+    return allocateBlock(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete(void* block, std::align_val_t,
+                     const std::nothrow_t&) noexcept
+{
+    freeBlock(block);
+}
+
+void operator delete[](void* block, std::align_val_t,
+                       const std::nothrow_t&) noexcept
+{
+    freeBlock(block);
+}
+
+#endif
@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   AllocationTracker.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Counts of the heap allocations made through operator new
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__ALLOCATION_TRACKER_HPP
+#define ROGUELIKE__ALLOCATION_TRACKER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Counts of the heap allocations made through operator new
+///
+/// In builds with ROGUELIKE_TRACK_ALLOCATIONS defined, the global operator
+/// new and delete are replaced by ones which count every allocation, in
+/// total and on each thread, along with the memory still allocated. The
+/// counts are otherwise always 0.
+///
+/// Counts only ever grow, so the allocations made over any stretch of time
+/// are the difference between the counts before and after it.
+///////////////////////////////////////////////////////////////////////////////
+class AllocationTracker {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Whether allocations are tracked in this build
+    ///////////////////////////////////////////////////////////////////////////
+#ifdef ROGUELIKE_TRACK_ALLOCATIONS
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of allocations and the bytes they requested
+    ///////////////////////////////////////////////////////////////////////////
+    struct Counts {
+        sf::Uint64 allocations;
+        sf::Uint64 bytes;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Leaves the allocations on this thread uncounted for its scope
+    ///
+    /// This is for the profiler and the debug overlay, whose own allocations
+    /// would otherwise hide those of the frames they measure. Memory
+    /// allocated in the scope still counts as live memory.
+    ///////////////////////////////////////////////////////////////////////////
+    class Untracked {
+    public:
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Stops counting the allocations on this thread
+        ///////////////////////////////////////////////////////////////////////
+        Untracked();
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Counts the allocations on this thread again, unless an
+        ///        enclosing scope still leaves them uncounted
+        ///////////////////////////////////////////////////////////////////////
+        ~Untracked();
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable copy constructor
+        ///////////////////////////////////////////////////////////////////////
+        Untracked(const Untracked&) = delete;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable assignment operator
+        ///////////////////////////////////////////////////////////////////////
+        void operator=(const Untracked&) = delete;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    AllocationTracker() = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the allocations counted on every thread
+    ///
+    /// @return Counts since the program started
+    ///////////////////////////////////////////////////////////////////////////
+    static Counts getTotalCounts();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the allocations counted on the calling thread
+    ///
+    /// @return Counts since the thread started
+    ///////////////////////////////////////////////////////////////////////////
+    static Counts getThreadCounts();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the memory allocated and not yet freed
+    ///
+    /// @return Number of bytes, which includes uncounted allocations
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Int64 getLiveBytes();
+};
+
+#endif
@@ -16,45 +16,67 @@
 #include <unordered_map>
 #include <SFML/Graphics.hpp>
 
+#include "Logger.hpp"
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Logging
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Lowest level of message logged, from 0 for debug to 2 for warnings
+///
+/// The macros of the levels below it expand to nothing, so their messages
+/// aren't even built. Exit messages are always logged.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef ROGUELIKE_LOG_LEVEL
+#define ROGUELIKE_LOG_LEVEL 1
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Logs a message only of use while debugging
+///
+/// @param msg  Message to log
+///////////////////////////////////////////////////////////////////////////////
+#if ROGUELIKE_LOG_LEVEL <= 0
+#define log_debug(msg) Logger::write(Logger::Debug, __FILE__, __func__, \
+                                     __LINE__, (msg))
+#else
+#define log_debug(msg) static_cast<void>(sizeof(msg))
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Logs an informational message
 ///
 /// @param msg  Message to log
 ///////////////////////////////////////////////////////////////////////////////
-#define log_info(msg) std::clog << "[EXIT]["    \
-    << __FILE__ << "]["                         \
-    << __func__ << "]["                         \
-    << __LINE__ << "]: "                        \
-    << (msg) << std::endl;
+#if ROGUELIKE_LOG_LEVEL <= 1
+#define log_info(msg) Logger::write(Logger::Info, __FILE__, __func__, \
+                                    __LINE__, (msg))
+#else
+#define log_info(msg) static_cast<void>(sizeof(msg))
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Logs a message indicating a recoverable runtime error
 ///
 /// @param msg  Message to log
 ///////////////////////////////////////////////////////////////////////////////
-#define log_warn(msg) std::cerr << "[EXIT]["    \
-    << __FILE__ << "]["                         \
-    << __func__ << "]["                         \
-    << __LINE__ << "]: "                        \
-    << (msg) << std::endl;
+#if ROGUELIKE_LOG_LEVEL <= 2
+#define log_warn(msg) Logger::write(Logger::Warn, __FILE__, __func__, \
+                                    __LINE__, (msg))
+#else
+#define log_warn(msg) static_cast<void>(sizeof(msg))
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Logs a message indicating a programming error
 ///
-/// std::exit(-1) is called after the message is logged.
+/// Every queued message and this one are written out before std::exit(-1)
+/// is called.
 ///
 /// @param msg  Message to log
 ///////////////////////////////////////////////////////////////////////////////
-#define log_exit(msg) std::cerr << "[EXIT]["    \
-    << __FILE__ << "]["                         \
-    << __func__ << "]["                         \
-    << __LINE__ << "]: "                        \
-    << (msg) << std::endl;                      \
-    std::exit(-1);                              \
+#define log_exit(msg) Logger::exit(__FILE__, __func__, __LINE__, (msg))
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Misc
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Components.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Component types stored in the EntityStore of a Zone
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__COMPONENTS_HPP
+#define ROGUELIKE__COMPONENTS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Tile coordinate of an entity within its Zone
+///
+/// This should only be changed through Zone::moveEntity() so that the Zone
+/// can keep its rendering up to date.
+///////////////////////////////////////////////////////////////////////////////
+struct Position {
+    sf::Vector2u coord;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Character and color drawn over the terrain at an entity's Position
+///////////////////////////////////////////////////////////////////////////////
+struct Glyph {
+    sf::Uint32 character;
+    sf::Color color;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Marks an entity that takes turns, and how quickly it acts
+///
+/// An actor with twice the NormalSpeed takes twice as many turns.
+///////////////////////////////////////////////////////////////////////////////
+struct Actor {
+    static constexpr sf::Uint32 NormalSpeed = 100;
+    sf::Uint32 speed = NormalSpeed;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Marks an actor controlled by the game rather than the player
+///
+/// The tier sets how closely the actor is simulated. Actors the player can
+/// see or is close to are Active and act on every one of their turns, while
+/// those further away act only once every few turns, with each action
+/// standing in for the turns skipped by wandering as far as they would
+/// have. The Zone updates the tier lazily as the actor acts and promotes
+/// actors to Active as soon as they come near.
+///////////////////////////////////////////////////////////////////////////////
+struct Brain {
+    enum class Tier : sf::Uint8 {
+        Active, Nearby, Distant
+    };
+
+    Tier tier = Tier::Active;
+};
+
+#endif
@@ -11,24 +11,216 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <cstdio>
+#include <algorithm>
+
 #include "State.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
-DebugManager::DebugManager(sf::Font& font) : m_fpsText("FPS: ", font, 16) {}
+DebugManager::DebugManager(sf::Font& font)
+    : m_fpsText("FPS: ", font, 16),
+      m_reportText("", font, 16),
+      m_graph(sf::Quads, (GraphFrames + 1) * 4)
+{
+    // The text isn't measured until it is shown, as that renders its glyphs
+    auto graph = getGraphBounds();
+    m_background.setSize({graph.width + 4.f, graph.top + graph.height + 4.f});
+    m_background.setFillColor(sf::Color(0, 0, 0, 160));
+    m_reportText.setPosition(0.f, graph.top + graph.height + 4.f);
+    updateGraph();
+}
 
 ///////////////////////////////////////////////////////////////////////////////
-void DebugManager::update()
+void DebugManager::addFrame(sf::Time frameTime)
 {
+    AllocationTracker::Untracked untracked;
+
+    const auto& allocations = State::get().profiler.getFrameAllocations();
+    m_allocations.allocations += allocations.allocations;
+    m_allocations.bytes += allocations.bytes;
+
+    const auto& draws = State::get().renderStats.getFrameCounts();
+    m_draws.drawCalls += draws.drawCalls;
+    m_draws.vertices += draws.vertices;
+    m_draws.textureSwitches += draws.textureSwitches;
+    m_draws.targetSwitches += draws.targetSwitches;
+
+    m_frameTimes[m_graphHead] = frameTime.asSeconds() * 1000.f;
+    m_graphHead = (m_graphHead + 1) % GraphFrames;
+
+    // The graph changes every frame, but is only rebuilt while it is shown
+    if (State::get().showDebug) {
+        updateGraph();
+        State::get().frameCompositor.addDamage(getGraphBounds());
+    }
+
     ++m_fpsCount;
-    if ((m_acc += State::get().deltaMs) > 1000) {
-        m_fpsText.setString("FPS: " + std::to_string(m_fpsCount));
+    if ((m_acc += frameTime) > sf::seconds(1)) {
+        auto bounds = getBounds();
+        const auto& times = State::get().profiler.getFrameTimes();
+        auto ms = [](sf::Time time) {
+            return time.asSeconds() * 1000.f;
+        };
+
+        // The percentiles cover the frames the report's histograms do,
+        // and so must be read before it advances them
+        char fps[128];
+        std::snprintf(fps, sizeof(fps),
+                      "FPS: %d  p50 %.1f  p95 %.1f  p99 %.1f  max %.1f ms",
+                      m_fpsCount, ms(times.getPercentile(50.f)),
+                      ms(times.getPercentile(95.f)),
+                      ms(times.getPercentile(99.f)),
+                      ms(times.getMaximum()));
+        m_fpsText.setString(fps);
         m_fpsCount = 0;
-        m_acc -= 1000;
+        m_acc -= sf::seconds(1);
+        updateReport();
+
+        // The old text may be larger than the new text
+        if (State::get().showDebug) {
+            State::get().frameCompositor.addDamage(bounds);
+            State::get().frameCompositor.addDamage(getBounds());
+        }
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+sf::FloatRect DebugManager::getBounds() const
+{
+    return m_background.getGlobalBounds();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void DebugManager::draw(sf::RenderTarget& target, sf::RenderStates) const
 {
+    target.draw(m_background);
     target.draw(m_fpsText);
+    target.draw(m_graph);
+    target.draw(m_reportText);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::FloatRect DebugManager::getGraphBounds()
+{
+    return {0.f, GraphTop, static_cast<float>(GraphFrames) * GraphBarWidth,
+            GraphHeight};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void DebugManager::updateGraph()
+{
+    auto bottom = GraphTop + GraphHeight;
+    auto budgetMs = 1000.f / 60.f;
+
+    for (sf::Uint32 i = 0; i < GraphFrames; ++i) {
+        auto ms = m_frameTimes[(m_graphHead + i) % GraphFrames];
+        auto top = bottom - std::min(ms / GraphMaxMs, 1.f) * GraphHeight;
+        auto left = static_cast<float>(i) * GraphBarWidth;
+        auto right = left + GraphBarWidth;
+
+        sf::Color color(80, 200, 80);
+        if (ms > budgetMs * 2.f) {
+            color = sf::Color(220, 60, 60);
+        }
+        else if (ms > budgetMs) {
+            color = sf::Color(220, 200, 60);
+        }
+
+        auto quad = &m_graph[i * 4];
+        quad[0] = sf::Vertex({left, top}, color);
+        quad[1] = sf::Vertex({right, top}, color);
+        quad[2] = sf::Vertex({right, bottom}, color);
+        quad[3] = sf::Vertex({left, bottom}, color);
+    }
+
+    // A line marks the time a frame has at 60 FPS
+    auto line = bottom - budgetMs / GraphMaxMs * GraphHeight;
+    auto width = static_cast<float>(GraphFrames) * GraphBarWidth;
+    auto quad = &m_graph[GraphFrames * 4];
+    quad[0] = sf::Vertex({0.f, line}, sf::Color(255, 255, 255, 128));
+    quad[1] = sf::Vertex({width, line}, sf::Color(255, 255, 255, 128));
+    quad[2] = sf::Vertex({width, line + 1.f}, sf::Color(255, 255, 255, 128));
+    quad[3] = sf::Vertex({0.f, line + 1.f}, sf::Color(255, 255, 255, 128));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void DebugManager::updateReport()
+{
+    static constexpr int NameWidth = 28;
+
+    auto& profiler = State::get().profiler;
+    auto frames = static_cast<float>(std::max(profiler.report(m_lines), 1u));
+
+    char line[160];
+    std::string text;
+
+    // The overlay draws directly, so its own draws aren't counted
+    std::snprintf(line, sizeof(line),
+                  "Draws: %.1f/frame, %.0f vertices, %.1f texture and %.1f "
+                  "target switches\n",
+                  static_cast<float>(m_draws.drawCalls) / frames,
+                  static_cast<float>(m_draws.vertices) / frames,
+                  static_cast<float>(m_draws.textureSwitches) / frames,
+                  static_cast<float>(m_draws.targetSwitches) / frames);
+    text += line;
+    m_draws = {0, 0, 0, 0};
+
+    if (AllocationTracker::Enabled) {
+        std::snprintf(line, sizeof(line),
+                      "Allocations: %.1f/frame, %.1f KB/frame, %.1f MB live\n",
+                      static_cast<float>(m_allocations.allocations) / frames,
+                      static_cast<float>(m_allocations.bytes) / frames /
+                          1024.f,
+                      static_cast<float>(AllocationTracker::getLiveBytes()) /
+                          (1024.f * 1024.f));
+        text += line;
+        m_allocations = {0, 0};
+    }
+
+    // Times are in ms per frame, the average over the last second and the
+    // percentiles over the profiler's statistics windows
+    std::snprintf(line, sizeof(line), "%-*s %6s %6s %6s %6s %6s %6s",
+                  NameWidth, "Zone", "avg", "p50", "p95", "p99", "max",
+                  "calls");
+    text += line;
+    text += AllocationTracker::Enabled ? "  allocs\n" : "\n";
+
+    for (const auto& zone : m_lines) {
+        auto indent = std::min(static_cast<int>(zone.depth) * 2, NameWidth);
+        std::snprintf(line, sizeof(line),
+                      "%*s%-*.*s %6.2f %6.2f %6.2f %6.2f %6.2f %6.1f",
+                      indent, "", NameWidth - indent, NameWidth - indent,
+                      zone.name, zone.average, zone.p50, zone.p95, zone.p99,
+                      zone.maximum, zone.calls);
+        text += line;
+
+        if (AllocationTracker::Enabled) {
+            std::snprintf(line, sizeof(line), " %7.1f", zone.allocations);
+            text += line;
+        }
+        text += "\n";
+    }
+
+    if (m_lines.empty()) {
+        text += "No zones profiled\n";
+    }
+    if (profiler.getDroppedCount()) {
+        text += "Dropped zones: " +
+                std::to_string(profiler.getDroppedCount()) + "\n";
+    }
+
+    m_reportText.setString(text);
+
+    // The background covers everything, with a small margin
+    auto bounds = m_fpsText.getGlobalBounds();
+    auto graph = getGraphBounds();
+    auto report = m_reportText.getGlobalBounds();
+    auto right = std::max({bounds.left + bounds.width,
+                           graph.left + graph.width,
+                           report.left + report.width});
+    auto bottom = std::max(graph.top + graph.height,
+                           report.top + report.height);
+
+    m_background.setPosition(0.f, 0.f);
+    m_background.setSize({right + 4.f, bottom + 4.f});
 }
@@ -12,24 +12,67 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <vector>
 #include <SFML/Graphics.hpp>
+
 #include "Common.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+#include "AllocationTracker.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Class to assist in debugging, manages rendered debug information
+///
+/// Shows the FPS and frame time percentiles, a graph of the time taken by
+/// the most recent frames and the profiler's report of every zone, all
+/// updated once per second except for the graph, along with the draws each
+/// frame submitted. When allocations are tracked, the report includes those
+/// of the frames and of each zone.
 ///////////////////////////////////////////////////////////////////////////////
 class DebugManager : public sf::Drawable {
 public:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of frames shown in the frame time graph
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 GraphFrames = 120;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Frame time at the top of the graph, in milliseconds
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr float GraphMaxMs = 100.f / 3.f;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Position and size of the frame time graph
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr float GraphTop = 22.f;
+    static constexpr float GraphHeight = 64.f;
+    static constexpr float GraphBarWidth = 2.f;
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Constructor
     ///////////////////////////////////////////////////////////////////////////
     explicit DebugManager(sf::Font& font);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Updates internal state, should be called once per frame
+    /// @brief Counts a rendered frame towards the FPS and the graph
+    ///
+    /// Frames are counted as they are rendered rather than as the simulation
+    /// steps, as the two no longer run at the same rate. This should be
+    /// called after the profiler's endFrame(). Its allocations are left
+    /// uncounted.
+    ///
+    /// @param frameTime    Time since the last rendered frame
+    ///////////////////////////////////////////////////////////////////////////
+    void addFrame(sf::Time frameTime);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the region of the frame the debug information covers
+    ///
+    /// @return Bounds in frame-space
     ///////////////////////////////////////////////////////////////////////////
-    void update();
+    sf::FloatRect getBounds() const;
 
 private:
 
@@ -38,9 +81,34 @@ private:
     ///////////////////////////////////////////////////////////////////////////
     void draw(sf::RenderTarget& target, sf::RenderStates) const override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the region of the frame the graph covers
+    ///
+    /// @return Bounds in frame-space
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::FloatRect getGraphBounds();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Rebuilds the bars of the frame time graph
+    ///////////////////////////////////////////////////////////////////////////
+    void updateGraph();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Shows the profiler's report of the last second
+    ///////////////////////////////////////////////////////////////////////////
+    void updateReport();
+
     ///////////////////////////////////////////////////////////////////////////
     sf::Text m_fpsText;
-    sf::Int32 m_acc = 0;
+    sf::Text m_reportText;
+    sf::RectangleShape m_background;
+    sf::VertexArray m_graph;
+    std::array<float, GraphFrames> m_frameTimes = {};
+    sf::Uint32 m_graphHead = 0;
+    std::vector<Profiler::Line> m_lines;
+    AllocationTracker::Counts m_allocations = {0, 0};
+    RenderStats::Counts m_draws = {0, 0, 0, 0};
+    sf::Time m_acc;
     sf::Int32 m_fpsCount = 0;
 };
 
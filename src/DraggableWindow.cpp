@@ -22,11 +22,11 @@ void DraggableWindow::updateDrag()
     if (consumeMouse) {
         if (State::get().getMouseStatus(MouseButton::Left)) {
             if (!m_dragging &&
-                Window::focus.empty() &&
+                Window::focus == WindowId() &&
                 State::get().leftClick) {
 
-                State::get().windowManager->setHighest(tag);
-                Window::focus = tag;
+                State::get().windowManager->setHighest(getId());
+                Window::focus = getId();
 
                 if (withinDraggableRegion(State::get().mousePosition)) {
                     m_dragging = true;
@@ -37,13 +37,13 @@ void DraggableWindow::updateDrag()
             }
             else if (m_dragging) {
                 if (!containsMouse()) {
-                    Window::focus.clear();
+                    Window::focus = WindowId();
                     m_dragging = false;
                 }
             }
         }
-        else if (m_dragging || !Window::focus.empty()) {
-            Window::focus.clear();
+        else if (m_dragging || Window::focus != WindowId()) {
+            Window::focus = WindowId();
             m_dragging = false;
         }
     }
@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   EntityStore.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Archetype-based (structure-of-arrays) storage for entities and
+///         their components
+///////////////////////////////////////////////////////////////////////////////
+
+#include "EntityStore.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+EntityStore::EntityStore()
+{
+    // Archetype 0 holds entities without any components
+    m_archetypes.emplace_back(std::make_unique<Archetype>());
+    m_archetypeIndices.insert({0, 0});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void EntityStore::destroy(Entity entity)
+{
+    const auto& slot = getSlot(entity);
+
+    removeRow(slot.archetype, slot.row);
+
+    m_slots[entity.index].alive = false;
+    ++m_slots[entity.index].generation;
+    m_freeSlots.push_back(entity.index);
+    --m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool EntityStore::isAlive(Entity entity) const
+{
+    return entity.index < m_slots.size() &&
+           m_slots[entity.index].alive &&
+           m_slots[entity.index].generation == entity.generation;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t EntityStore::size() const
+{
+    return m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 EntityStore::getIndexCount() const
+{
+    return static_cast<sf::Uint32>(m_slots.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void EntityStore::reserve(std::size_t count)
+{
+    m_slots.reserve(count);
+    m_freeSlots.reserve(count);
+
+    for (auto& archetype : m_archetypes) {
+        archetype->entities.reserve(count);
+        for (auto& column : archetype->columns) {
+            if (column) {
+                column->reserve(count);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 EntityStore::nextComponentId()
+{
+    static sf::Uint32 next = 0;
+
+    if (next >= MaxComponents) {
+        log_exit("Too many component types");
+    }
+
+    return next++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Int64 EntityStore::findArchetype(ComponentMask mask) const
+{
+    auto it = m_archetypeIndices.find(mask);
+    return it != m_archetypeIndices.end()
+        ? static_cast<sf::Int64>(it->second) : -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 EntityStore::createArchetype(ComponentMask mask,
+                                        const Archetype& first,
+                                        const Archetype& second)
+{
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+
+    for (sf::Uint32 id = 0; id < MaxComponents; ++id) {
+        if (!(mask & (1u << id))) {
+            continue;
+        }
+
+        if (first.columns[id]) {
+            archetype->columns[id] = first.columns[id]->makeEmpty();
+        }
+        else if (second.columns[id]) {
+            archetype->columns[id] = second.columns[id]->makeEmpty();
+        }
+        else {
+            log_exit("No column type for component id " + std::to_string(id));
+        }
+    }
+
+    auto index = static_cast<sf::Uint32>(m_archetypes.size());
+    m_archetypes.emplace_back(std::move(archetype));
+    m_archetypeIndices.insert({mask, index});
+
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Entity EntityStore::allocate()
+{
+    sf::Uint32 index;
+
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<sf::Uint32>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    m_slots[index].alive = true;
+    ++m_size;
+
+    return {index, m_slots[index].generation};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void EntityStore::migrate(Entity entity, sf::Uint32 target)
+{
+    auto& slot = m_slots[entity.index];
+    auto& from = *m_archetypes[slot.archetype];
+    auto& to = *m_archetypes[target];
+    auto shared = from.mask & to.mask;
+
+    for (sf::Uint32 id = 0; id < MaxComponents; ++id) {
+        if (shared & (1u << id)) {
+            to.columns[id]->moveFrom(*from.columns[id], slot.row);
+        }
+    }
+
+    auto oldArchetype = slot.archetype;
+    auto oldRow = slot.row;
+
+    slot.archetype = target;
+    slot.row = static_cast<sf::Uint32>(to.entities.size());
+    to.entities.push_back(entity);
+
+    removeRow(oldArchetype, oldRow);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void EntityStore::removeRow(sf::Uint32 index, sf::Uint32 row)
+{
+    auto& archetype = *m_archetypes[index];
+
+    for (auto& column : archetype.columns) {
+        if (column) {
+            column->swapRemove(row);
+        }
+    }
+
+    // The last entity is swapped into the removed row
+    if (row + 1 != archetype.entities.size()) {
+        archetype.entities[row] = archetype.entities.back();
+        m_slots[archetype.entities[row].index].row = row;
+    }
+    archetype.entities.pop_back();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const EntityStore::Slot& EntityStore::getSlot(Entity entity) const
+{
+    if (!isAlive(entity)) {
+        log_exit("Entity is not alive: " + std::to_string(entity.index));
+    }
+
+    return m_slots[entity.index];
+}
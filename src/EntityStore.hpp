@@ -0,0 +1,537 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   EntityStore.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Archetype-based (structure-of-arrays) storage for entities and
+///         their components
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__ENTITY_STORE_HPP
+#define ROGUELIKE__ENTITY_STORE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <SFML/System.hpp>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Stable handle to an entity
+///
+/// The index of a destroyed entity is reused, but with a new generation, so
+/// stale handles can be detected with EntityStore::isAlive().
+///////////////////////////////////////////////////////////////////////////////
+struct Entity {
+    sf::Uint32 index;
+    sf::Uint32 generation;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+inline bool operator==(const Entity& left, const Entity& right)
+{
+    return left.index == right.index && left.generation == right.generation;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline bool operator!=(const Entity& left, const Entity& right)
+{
+    return !(left == right);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Stores entities grouped by their exact set of components
+///
+/// Each distinct set of components (an archetype) stores every component
+/// type in its own contiguous array, so iterating over a set of components
+/// with each() walks tightly packed memory. Adding or removing a component
+/// moves the entity to another archetype, so those operations are more
+/// expensive than reading or writing components.
+///
+/// Components can be any movable, default constructible type. Entities must
+/// not be created, destroyed or have components added or removed while
+/// inside of each().
+///////////////////////////////////////////////////////////////////////////////
+class EntityStore {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Maximum number of distinct component types
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MaxComponents = 32;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Bitmask with one bit set per component type
+    ///////////////////////////////////////////////////////////////////////////
+    typedef sf::Uint32 ComponentMask;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///////////////////////////////////////////////////////////////////////////
+    EntityStore();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    EntityStore(const EntityStore&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const EntityStore&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates a new entity directly in the archetype of its
+    ///        components
+    ///
+    /// @param components   Initial values of the entity's components
+    ///
+    /// @return Handle to the new entity
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename... Components>
+    Entity create(Components&&... components);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Destroys an entity and all of its components
+    ///
+    /// @param entity   Handle of the entity to destroy
+    ///////////////////////////////////////////////////////////////////////////
+    void destroy(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not a handle refers to a living entity
+    ///
+    /// @param entity   Handle to check
+    ///
+    /// @return True if the entity has not been destroyed, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool isAlive(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not an entity has a component
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return True if the entity has the component, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    bool has(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a reference to one of an entity's components
+    ///
+    /// The reference is invalidated by any call which creates or destroys
+    /// entities or adds or removes components.
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return Reference to the component
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    Component& get(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a const reference to one of an entity's components
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return Const reference to the component
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    const Component& get(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a component to an entity, or replaces it if it exists
+    ///
+    /// @param entity       Handle of the entity
+    /// @param component    Value of the component
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    void add(Entity entity, Component&& component);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a component from an entity
+    ///
+    /// @param entity   Handle of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    void remove(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls a function for every entity with a set of components
+    ///
+    /// The function is called as function(Entity, Components&...).
+    ///
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename... Components, typename Function>
+    void each(Function&& function);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of living entities
+    ///
+    /// @return The number of living entities
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t size() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns one more than the highest entity index in use
+    ///
+    /// This is useful for sizing arrays indexed by Entity::index.
+    ///
+    /// @return The capacity of the entity index space currently in use
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getIndexCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reserves space for entities to avoid later reallocation
+    ///
+    /// @param count    Number of entities to reserve space for
+    ///////////////////////////////////////////////////////////////////////////
+    void reserve(std::size_t count);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Type-erased array of a single component type
+    ///////////////////////////////////////////////////////////////////////////
+    class Column {
+    public:
+        virtual ~Column() = default;
+        virtual std::unique_ptr<Column> makeEmpty() const = 0;
+        virtual void moveFrom(Column& other, sf::Uint32 row) = 0;
+        virtual void swapRemove(sf::Uint32 row) = 0;
+        virtual void reserve(std::size_t count) = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Array of a single component type
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    class TypedColumn : public Column {
+    public:
+        std::unique_ptr<Column> makeEmpty() const override
+        {
+            return std::make_unique<TypedColumn<Component>>();
+        }
+
+        void moveFrom(Column& other, sf::Uint32 row) override
+        {
+            data.push_back(std::move(
+                static_cast<TypedColumn<Component>&>(other).data[row]));
+        }
+
+        void swapRemove(sf::Uint32 row) override
+        {
+            if (row + 1 != data.size()) {
+                data[row] = std::move(data.back());
+            }
+            data.pop_back();
+        }
+
+        void reserve(std::size_t count) override
+        {
+            data.reserve(count);
+        }
+
+        std::vector<Component> data;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief All entities sharing an exact set of components
+    ///////////////////////////////////////////////////////////////////////////
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::vector<Entity> entities;
+        std::array<std::unique_ptr<Column>, MaxComponents> columns;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Location of an entity within the archetypes
+    ///////////////////////////////////////////////////////////////////////////
+    struct Slot {
+        sf::Uint32 archetype = 0;
+        sf::Uint32 row = 0;
+        sf::Uint32 generation = 0;
+        bool alive = false;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a unique, sequential id for each component type
+    ///
+    /// @return The id of the component type
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    static sf::Uint32 componentId();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the next unused component id
+    ///
+    /// @return The next unused component id
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint32 nextComponentId();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the mask of a set of component types
+    ///
+    /// @return Mask with the bits for every component type set
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename... Components>
+    static ComponentMask componentMask();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the typed array of a component type in an archetype
+    ///
+    /// @param archetype    Archetype containing the component type
+    ///
+    /// @return The array of the component type
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Component>
+    static std::vector<Component>& column(Archetype& archetype);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the archetype with a mask, or -1
+    ///
+    /// @param mask Mask of the archetype
+    ///
+    /// @return Index of the archetype in m_archetypes, or -1 if none exists
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Int64 findArchetype(ComponentMask mask) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates a new, empty archetype
+    ///
+    /// The type of each column is copied from first if it has that column,
+    /// otherwise from second.
+    ///
+    /// @param mask     Mask of the archetype
+    /// @param first    Archetype to copy column types from
+    /// @param second   Archetype to copy the remaining column types from
+    ///
+    /// @return Index of the new archetype in m_archetypes
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 createArchetype(ComponentMask mask,
+                               const Archetype& first,
+                               const Archetype& second);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Allocates a slot for a new entity
+    ///
+    /// @return Handle to the new entity
+    ///////////////////////////////////////////////////////////////////////////
+    Entity allocate();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves an entity into another archetype
+    ///
+    /// Components not present in the target archetype are dropped. The
+    /// target's columns not present in the source are left for the caller
+    /// to fill.
+    ///
+    /// @param entity   Handle of the entity to move
+    /// @param target   Index of the archetype to move the entity into
+    ///////////////////////////////////////////////////////////////////////////
+    void migrate(Entity entity, sf::Uint32 target);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a row from an archetype, patching the slot of the
+    ///        entity that is moved into its place
+    ///
+    /// @param archetype    Index of the archetype
+    /// @param row          Row to remove
+    ///////////////////////////////////////////////////////////////////////////
+    void removeRow(sf::Uint32 archetype, sf::Uint32 row);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the slot of a living entity
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return The slot of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    const Slot& getSlot(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t m_size = 0;
+    std::vector<Slot> m_slots;
+    std::vector<sf::Uint32> m_freeSlots;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, sf::Uint32> m_archetypeIndices;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Template implementation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename... Components>
+Entity EntityStore::create(Components&&... components)
+{
+    auto mask = componentMask<std::decay_t<Components>...>();
+    auto found = findArchetype(mask);
+
+    sf::Uint32 index;
+    if (found >= 0) {
+        index = static_cast<sf::Uint32>(found);
+    }
+    else {
+        Archetype prototype;
+        using Expand = int[];
+        (void)Expand{0, (prototype.columns[
+            componentId<std::decay_t<Components>>()] =
+                std::make_unique<TypedColumn<std::decay_t<Components>>>(),
+            0)...};
+        index = createArchetype(mask, prototype, prototype);
+    }
+
+    auto& archetype = *m_archetypes[index];
+    auto entity = allocate();
+    auto& slot = m_slots[entity.index];
+    slot.archetype = index;
+    slot.row = static_cast<sf::Uint32>(archetype.entities.size());
+
+    archetype.entities.push_back(entity);
+    using Expand = int[];
+    (void)Expand{0, (column<std::decay_t<Components>>(archetype).push_back(
+        std::forward<Components>(components)), 0)...};
+
+    return entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+bool EntityStore::has(Entity entity) const
+{
+    const auto& slot = getSlot(entity);
+    return (m_archetypes[slot.archetype]->mask &
+            componentMask<Component>()) != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+Component& EntityStore::get(Entity entity)
+{
+    const auto& slot = getSlot(entity);
+    auto& archetype = *m_archetypes[slot.archetype];
+
+    if (!(archetype.mask & componentMask<Component>())) {
+        log_exit("Entity does not have the requested component");
+    }
+
+    return column<Component>(archetype)[slot.row];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+const Component& EntityStore::get(Entity entity) const
+{
+    return const_cast<EntityStore*>(this)->get<Component>(entity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+void EntityStore::add(Entity entity, Component&& component)
+{
+    typedef std::decay_t<Component> Type;
+
+    const auto& slot = getSlot(entity);
+    auto& source = *m_archetypes[slot.archetype];
+
+    if (source.mask & componentMask<Type>()) {
+        column<Type>(source)[slot.row] = std::forward<Component>(component);
+        return;
+    }
+
+    auto mask = source.mask | componentMask<Type>();
+    auto found = findArchetype(mask);
+
+    sf::Uint32 target;
+    if (found >= 0) {
+        target = static_cast<sf::Uint32>(found);
+    }
+    else {
+        Archetype prototype;
+        prototype.columns[componentId<Type>()] =
+            std::make_unique<TypedColumn<Type>>();
+        target = createArchetype(mask, source, prototype);
+    }
+
+    migrate(entity, target);
+    column<Type>(*m_archetypes[target]).push_back(
+        std::forward<Component>(component));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+void EntityStore::remove(Entity entity)
+{
+    const auto& slot = getSlot(entity);
+    auto& source = *m_archetypes[slot.archetype];
+
+    if (!(source.mask & componentMask<Component>())) {
+        return;
+    }
+
+    auto mask = source.mask & ~componentMask<Component>();
+    auto found = findArchetype(mask);
+
+    migrate(entity, found >= 0 ? static_cast<sf::Uint32>(found)
+                               : createArchetype(mask, source, source));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename... Components, typename Function>
+void EntityStore::each(Function&& function)
+{
+    auto mask = componentMask<Components...>();
+
+    for (auto& archetype : m_archetypes) {
+        if ((archetype->mask & mask) != mask || archetype->entities.empty()) {
+            continue;
+        }
+
+        // Resolve each column once so the inner loop is plain array access
+        const Entity* entities = archetype->entities.data();
+        auto columns = std::make_tuple(
+            column<Components>(*archetype).data()...);
+        auto count = archetype->entities.size();
+
+        for (std::size_t row = 0; row < count; ++row) {
+            function(entities[row], std::get<Components*>(columns)[row]...);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+sf::Uint32 EntityStore::componentId()
+{
+    static const sf::Uint32 id = nextComponentId();
+    return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename... Components>
+EntityStore::ComponentMask EntityStore::componentMask()
+{
+    ComponentMask mask = 0;
+    using Expand = int[];
+    (void)Expand{0, (mask |= (1u << componentId<Components>()), 0)...};
+    return mask;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Component>
+std::vector<Component>& EntityStore::column(Archetype& archetype)
+{
+    return static_cast<TypedColumn<Component>&>(
+        *archetype.columns[componentId<Component>()]).data;
+}
+
+#endif
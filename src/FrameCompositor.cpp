@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   FrameCompositor.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Redraws only the damaged regions of a persistent frame buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCompositor.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameCompositor::create(const sf::Vector2u& frameSize)
+{
+    m_frameSize = frameSize;
+    damageAll();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameCompositor::addDamage(const sf::IntRect& rect)
+{
+    if (m_damageAll) {
+        return;
+    }
+
+    auto left = std::max(rect.left, 0);
+    auto top = std::max(rect.top, 0);
+    auto right = std::min(rect.left + rect.width,
+                          static_cast<int>(m_frameSize.x));
+    auto bottom = std::min(rect.top + rect.height,
+                           static_cast<int>(m_frameSize.y));
+
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    sf::IntRect damage(left, top, right - left, bottom - top);
+
+    while (true) {
+        // Absorb every region the damage touches, which may make it touch
+        // regions it did not before
+        for (std::size_t i = 0; i < m_rects.size();) {
+            if (touches(m_rects[i], damage)) {
+                damage = unite(m_rects[i], damage);
+                m_rects[i] = m_rects.back();
+                m_rects.pop_back();
+                i = 0;
+            }
+            else {
+                ++i;
+            }
+        }
+
+        if (m_rects.size() < MaxRects) {
+            break;
+        }
+
+        // Too many regions, so merge with the one which grows the least
+        std::size_t best = 0;
+        auto bestGrowth = getArea(unite(m_rects[0], damage)) -
+                          getArea(m_rects[0]);
+        for (std::size_t i = 1; i < m_rects.size(); ++i) {
+            auto growth = getArea(unite(m_rects[i], damage)) -
+                          getArea(m_rects[i]);
+            if (growth < bestGrowth) {
+                best = i;
+                bestGrowth = growth;
+            }
+        }
+
+        damage = unite(m_rects[best], damage);
+        m_rects[best] = m_rects.back();
+        m_rects.pop_back();
+    }
+
+    m_rects.push_back(damage);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameCompositor::addDamage(const sf::FloatRect& rect)
+{
+    auto left = static_cast<int>(std::floor(rect.left));
+    auto top = static_cast<int>(std::floor(rect.top));
+    auto right = static_cast<int>(std::ceil(rect.left + rect.width));
+    auto bottom = static_cast<int>(std::ceil(rect.top + rect.height));
+
+    addDamage(sf::IntRect(left, top, right - left, bottom - top));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void FrameCompositor::damageAll()
+{
+    m_rects.assign(1, sf::IntRect(0, 0, static_cast<int>(m_frameSize.x),
+                                  static_cast<int>(m_frameSize.y)));
+    m_damageAll = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<sf::IntRect>& FrameCompositor::getDamage() const
+{
+    return m_rects;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool FrameCompositor::compose(sf::RenderTexture& buffer,
+                              const sf::Drawable& scene)
+{
+    if (m_rects.empty()) {
+        return false;
+    }
+
+    if (m_damageAll) {
+        buffer.setView(buffer.getDefaultView());
+        buffer.clear();
+        buffer.draw(scene);
+    }
+    else {
+        auto size = sf::Vector2f(buffer.getSize());
+
+        for (const auto& rect : m_rects) {
+            auto area = sf::FloatRect(rect);
+
+            // The viewport clips everything drawn to the damaged region
+            sf::View view(area);
+            view.setViewport(sf::FloatRect(area.left / size.x,
+                                           area.top / size.y,
+                                           area.width / size.x,
+                                           area.height / size.y));
+            buffer.setView(view);
+
+            // clear() ignores the viewport, so cover the region instead
+            auto right = area.left + area.width;
+            auto bottom = area.top + area.height;
+            sf::Vertex clear[] = {
+                sf::Vertex({area.left, area.top}, sf::Color::Black),
+                sf::Vertex({right, area.top}, sf::Color::Black),
+                sf::Vertex({right, bottom}, sf::Color::Black),
+                sf::Vertex({area.left, bottom}, sf::Color::Black)
+            };
+            State::get().renderStats.draw(buffer, clear, 4, sf::Quads,
+                                          sf::RenderStates(sf::BlendNone));
+            buffer.draw(scene);
+        }
+
+        buffer.setView(buffer.getDefaultView());
+    }
+
+    buffer.display();
+    m_rects.clear();
+    m_damageAll = false;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool FrameCompositor::touches(const sf::IntRect& a, const sf::IntRect& b)
+{
+    return a.left <= b.left + b.width && b.left <= a.left + a.width &&
+           a.top <= b.top + b.height && b.top <= a.top + a.height;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::IntRect FrameCompositor::unite(const sf::IntRect& a, const sf::IntRect& b)
+{
+    auto left = std::min(a.left, b.left);
+    auto top = std::min(a.top, b.top);
+    auto right = std::max(a.left + a.width, b.left + b.width);
+    auto bottom = std::max(a.top + a.height, b.top + b.height);
+
+    return {left, top, right - left, bottom - top};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Int64 FrameCompositor::getArea(const sf::IntRect& rect)
+{
+    return static_cast<sf::Int64>(rect.width) * rect.height;
+}
@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   FrameCompositor.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Redraws only the damaged regions of a persistent frame buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__FRAME_COMPOSITOR_HPP
+#define ROGUELIKE__FRAME_COMPOSITOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Redraws only the damaged regions of a persistent frame buffer
+///
+/// Anything which changes what a region of the frame looks like (scrolling,
+/// moving a window, changing text, etc...) reports that region as damaged
+/// during the frame. compose() then redraws the scene once per damaged
+/// region, with a view whose viewport covers only that region, so the GPU
+/// only touches the damaged pixels and the rest of the buffer is left as it
+/// was. Touching regions are merged, and once there are MaxRects regions new
+/// damage is merged into whichever region grows the least, so the number of
+/// times the scene is drawn stays small. A frame with no damage draws nothing.
+///////////////////////////////////////////////////////////////////////////////
+class FrameCompositor {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Maximum number of separately redrawn regions per frame
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr std::size_t MaxRects = 8;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor, create() must be called before use
+    ///////////////////////////////////////////////////////////////////////////
+    FrameCompositor() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    FrameCompositor(const FrameCompositor&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const FrameCompositor&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief (Re)creates the FrameCompositor with the whole frame damaged
+    ///
+    /// @param frameSize    Size of the frame in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    void create(const sf::Vector2u& frameSize);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks a region of the frame as needing to be redrawn
+    ///
+    /// @param rect Region in frame-space, clipped to the frame
+    ///////////////////////////////////////////////////////////////////////////
+    void addDamage(const sf::IntRect& rect);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks a region of the frame as needing to be redrawn
+    ///
+    /// @param rect Region in frame-space, rounded outwards to whole pixels
+    ///////////////////////////////////////////////////////////////////////////
+    void addDamage(const sf::FloatRect& rect);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks the whole frame as needing to be redrawn
+    ///////////////////////////////////////////////////////////////////////////
+    void damageAll();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the regions which will be redrawn by compose()
+    ///
+    /// @return The damaged regions, or the whole frame
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<sf::IntRect>& getDamage() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Redraws the damaged regions of a frame buffer
+    ///
+    /// The damage is cleared afterwards.
+    ///
+    /// @param buffer   Frame buffer, holding the previously composed frame
+    /// @param scene    Drawable drawing the whole frame
+    ///
+    /// @return True if anything was redrawn
+    ///////////////////////////////////////////////////////////////////////////
+    bool compose(sf::RenderTexture& buffer, const sf::Drawable& scene);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether two rectangles overlap or share an edge
+    ///
+    /// @param a    First rectangle
+    /// @param b    Second rectangle
+    ///
+    /// @return True if the rectangles touch
+    ///////////////////////////////////////////////////////////////////////////
+    static bool touches(const sf::IntRect& a, const sf::IntRect& b);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the smallest rectangle containing two rectangles
+    ///
+    /// @param a    First rectangle
+    /// @param b    Second rectangle
+    ///
+    /// @return Bounding rectangle of both
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::IntRect unite(const sf::IntRect& a, const sf::IntRect& b);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the area of a rectangle
+    ///
+    /// @param rect The rectangle
+    ///
+    /// @return Area in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Int64 getArea(const sf::IntRect& rect);
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Vector2u m_frameSize;
+    std::vector<sf::IntRect> m_rects;
+    bool m_damageAll = true;
+};
+
+#endif
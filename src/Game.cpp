@@ -11,15 +11,19 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cmath>
+#include <ctime>
 #include <cstdlib>
 #include <iostream>
 
 #include "State.hpp"
 #include "Common.hpp"
 #include "ZoneManager.hpp"
+#include "DebugManager.hpp"
+#include "AllocationTracker.hpp"
 #include "GlyphTileMap.hpp"
 #include "WindowManager.hpp"
 #include "DraggableWindow.hpp"
+#include "MessageLogWindow.hpp"
 
 
 // TODO: Remove this
@@ -36,10 +40,11 @@ public:
             static_cast<int>(m_glyphMap.getSpacing().x),
             static_cast<int>(m_glyphMap.getSpacing().y));
 
+        auto& random = State::get().random;
         auto background_color = sf::Color(
-            rand() % 30 + 40,
-            rand() % 30 + 40,
-            rand() % 30 + 40
+            static_cast<sf::Uint8>(random.between(40, 69)),
+            static_cast<sf::Uint8>(random.between(40, 69)),
+            static_cast<sf::Uint8>(random.between(40, 69))
         );
         auto foreground_color = sf::Color(
             background_color.r + 40,
@@ -175,9 +180,11 @@ public:
             m_glyphMap.setTileFgColor({2 + i, 5}, sf::Color(200, 200, 200));
         }
 
-        setPosition(rand() % static_cast<int>(State::get().frameSize.x * 0.75),
-                    rand() % static_cast<int>(State::get().frameSize.y
-                                              * 0.75));
+        setPosition(
+            static_cast<float>(random.below(static_cast<sf::Uint32>(
+                State::get().frameSize.x * 0.75))),
+            static_cast<float>(random.below(static_cast<sf::Uint32>(
+                State::get().frameSize.y * 0.75))));
     }
 
     void update() override
@@ -196,6 +203,29 @@ public:
         return containsPosition(State::get().mousePosition);
     }
 
+    sf::FloatRect getBounds() const override
+    {
+        auto area = m_glyphMap.getArea();
+        auto spacing = m_glyphMap.getSpacing();
+
+        return getTransform().transformRect(sf::FloatRect(
+            0.f, 0.f,
+            static_cast<float>(area.x * spacing.x),
+            static_cast<float>(area.y * spacing.y)));
+    }
+
+    sf::Uint64 getContentVersion() const override
+    {
+        return m_glyphMap.getVersion();
+    }
+
+    bool appendVertices(RenderBatch& batch) const override
+    {
+        m_glyphMap.appendVertices(
+            batch.getVertices(&m_glyphMap.getTexture()), getTransform());
+        return true;
+    }
+
     bool containsPosition(const sf::Vector2i& position) const override
     {
         auto thisPosition = getPosition();
@@ -257,101 +287,309 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 Game::Game(Settings& settings)
+    : m_stepMs(settings.simulation.stepMs),
+      m_maxSteps(settings.simulation.maxSteps),
+      m_recordPath(settings.session.recordPath),
+      m_statsPath(settings.session.statsPath),
+      m_baselinePath(settings.baseline.path),
+      m_tolerance(settings.baseline.tolerance),
+      m_replaying(!settings.session.replayPath.empty() ||
+                  !settings.session.scriptPath.empty()),
+      m_offscreen(settings.session.offscreen),
+      m_traceLength(sf::seconds(static_cast<float>(settings.trace.seconds))),
+      m_slowFrame(sf::milliseconds(settings.trace.slowFrameMs)),
+      m_sinceTrace(m_traceLength),
+      m_checkAllocations(settings.allocations.check),
+      m_allocationWarmup(settings.allocations.warmupFrames)
 {
-    State::get().frameSize = settings.frame.size;
-    State::get().gameWindow.create(settings.window.mode,
-                                   settings.window.title,
-                                   settings.window.style);
+    const auto& session = settings.session;
+    Profiler::setThreadName("Main");
+    State::get().profiler.setHistory(m_traceLength);
+
+    if (m_stepMs <= 0 || !m_maxSteps) {
+        log_exit("Invalid simulation step settings");
+    }
+    else if (!session.replayPath.empty() && !session.scriptPath.empty()) {
+        log_exit("Cannot replay and run a script at once");
+    }
+    else if (session.headless && !m_replaying) {
+        log_exit("Headless games need a replay or script for input");
+    }
+    else if (m_checkAllocations && !AllocationTracker::Enabled) {
+        log_exit("Checking allocations needs ROGUELIKE_TRACK_ALLOCATIONS");
+    }
+    else if (m_offscreen && (session.headless || !m_replaying)) {
+        log_exit("Only replays and scripts with a window run offscreen");
+    }
+    else if (!m_baselinePath.empty() && (!m_replaying ||
+                                         m_statsPath.empty())) {
+        log_exit("Baselines need a replay or script and a statistics path");
+    }
 
-    if (!State::get().gameWindow.isOpen()) {
-        log_exit("Could not open window");
+    auto seed = session.seed;
+
+    if (!session.replayPath.empty()) {
+        if (!m_recording.loadFromFile(session.replayPath)) {
+            log_exit("Could not load replay: " + session.replayPath);
+        }
+        seed = m_recording.getSeed();
     }
-    else if (!State::get().frameBuffer.create(settings.frame.size.x,
-                                              settings.frame.size.y)) {
-        log_exit("Could not create frame buffer");
+    else if (!session.scriptPath.empty()) {
+        if (!m_recording.loadFromScript(session.scriptPath, seed, m_stepMs)) {
+            log_exit("Could not load script: " + session.scriptPath);
+        }
+        seed = m_recording.getSeed();
+    }
+    else {
+        m_recording.clear(seed);
     }
 
-    State::get().gameWindow.setVerticalSyncEnabled(settings.window.vsync);
-    State::get().gameWindow.setFramerateLimit(settings.window.fpsLimit);
-    State::get().gameWindow.setMouseCursorVisible(true);
-    State::get().gameWindow.setActive();
+    // Everything random is drawn from the seed, so that the session can be
+    // played out again
+    State::get().random.seed(seed);
+    State::get().deterministic = m_replaying || !m_recordPath.empty();
 
-    updateFrameScale();
+    State::get().headless = session.headless;
+    State::get().frameSize = settings.frame.size;
+    State::get().frameCompositor.create(settings.frame.size);
+
+    if (session.headless) {
+        State::get().frameScale = {1.f, 1.f};
+    }
+    else {
+        auto& window = State::get().gameWindow;
+        auto& frameBuffer = State::get().frameBuffer;
+        window = std::make_unique<sf::RenderWindow>(settings.window.mode,
+                                                    settings.window.title,
+                                                    settings.window.style);
+        frameBuffer = std::make_unique<sf::RenderTexture>();
+
+        if (!window->isOpen()) {
+            log_exit("Could not open window");
+        }
+        else if (!frameBuffer->create(settings.frame.size.x,
+                                      settings.frame.size.y)) {
+            log_exit("Could not create frame buffer");
+        }
+
+        // Replays run as fast as they can
+        window->setVerticalSyncEnabled(settings.window.vsync && !m_replaying);
+        window->setFramerateLimit(m_replaying ? 0 : settings.window.fpsLimit);
+        window->setMouseCursorVisible(true);
+        window->setActive();
+
+        updateFrameScale(window->getSize());
+    }
 
     // TODO: Remove this!
 
     State::get().zoneManager->addZone(new Zone());
     State::get().zoneManager->setCurrentZone("default");
 
+    State::get().windowManager->addWindow(
+        new MessageLogWindow("messages", State::get().messageLog, 6));
+    State::get().messageLog.push("Welcome! Move with hjklyubn, wait with "
+                                 "space and rest with z.",
+                                 sf::Color(255, 220, 120));
+
     // TODO: ^
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void Game::play()
+bool Game::play()
 {
+    if (m_replaying) {
+        replay();
+        return checkBaseline();
+    }
+
+    if (!m_renderThread.start(*State::get().gameWindow,
+                              State::get().frameSize)) {
+        log_exit("Could not start render thread");
+    }
+
+    auto step = sf::milliseconds(m_stepMs);
     sf::Clock clock;
 
-    while (State::get().gameWindow.isOpen()) {
+    // Start with a step due, so the first frame isn't drawn before the
+    // state has been updated
+    auto accumulator = step;
+
+    while (m_running) {
+        auto frameTime = clock.restart();
+        accumulator += frameTime;
         updateFrameMouseCoord();
-        State::get().leftClick = false;
-        State::get().rightClick = false;
-        State::get().updateKeyStatuses();
-        State::get().clearAllKeyPressedStatuses();
-        State::get().deltaMs = clock.restart().asMilliseconds();
 
+        // The last frame's zones were collected at the end of it
+        m_sinceTrace += frameTime;
+        if (m_slowFrame > sf::Time::Zero && frameTime > m_slowFrame &&
+            m_sinceTrace >= m_traceLength) {
+            writeTrace("frame took " +
+                       std::to_string(frameTime.asMilliseconds()) + " ms");
+        }
+
+        {
+            profile_scope("Game::pollEvents");
+            sf::Event event;
+            while (m_renderThread.pollEvent(event)) {
+                switch (event.type) {
+                    case sf::Event::Closed:
+                        quit();
+                        break;
+                    case sf::Event::Resized:
+                        updateFrameScale({event.size.width,
+                                          event.size.height});
+                        break;
+                    default:
+                        State::get().handleEvent(event);
+                        break;
+                }
+            }
+        }
+
+        sf::Uint32 steps = 0;
+        while (accumulator >= step && steps < m_maxSteps && m_running) {
+            profile_scope("Game::step");
+            State::get().deltaMs = m_stepMs;
+
+            if (!m_recordPath.empty()) {
+                m_recording.addFrame(State::get().deltaMs,
+                                     State::get().mousePosition,
+                                     State::get().getInputEvents());
+            }
+
+            updateState();
+
+            // Input is only cleared once a step has seen it
+            State::get().clearFrameInput();
+            State::get().lastMousePosition = State::get().mousePosition;
+            accumulator -= step;
+            ++steps;
+        }
+
+        if (!m_running) {
+            break;
+        }
+
+        // Drop what couldn't be caught up on, rather than spend the frames
+        // after a hitch catching up and hitch again
+        if (accumulator >= step) {
+            accumulator = sf::microseconds(
+                accumulator.asMicroseconds() % step.asMicroseconds());
+        }
+
+        {
+            profile_scope("State::interpolate");
+            State::get().interpolate(
+                accumulator.asSeconds() / step.asSeconds());
+        }
+
+        renderFrame();
+
+        // The zones of this frame have all ended, other than on the render
+        // thread, whose zones are collected with the next frame's
+        State::get().profiler.endFrame(frameTime);
+        State::get().renderStats.endFrame();
+        checkAllocations();
+        State::get().debugManager->addFrame(frameTime);
+    }
+
+    if (!m_recordPath.empty() && m_recording.saveToFile(m_recordPath)) {
+        log_info("Recorded " + std::to_string(m_recording.getFrameCount()) +
+                 " frames to " + m_recordPath);
+    }
+
+    if (!m_statsPath.empty()) {
+        writeStatistics(m_statsPath);
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Game::replay()
+{
+    sf::Clock clock;
+    sf::Uint32 index = 0;
+
+    sf::Clock stepClock;
+
+    // The replay stops early if it quits, as the session did
+    for (; index < m_recording.getFrameCount() && m_running; ++index) {
+        const auto& frame = m_recording.getFrame(index);
+        auto events = m_recording.getEvents(frame);
+
+        State::get().deltaMs = frame.deltaMs;
+        State::get().mousePosition = frame.mousePosition;
+
+        for (sf::Uint32 i = 0; i < frame.eventCount; ++i) {
+            State::get().handleInputEvent(events[i]);
+        }
+
+        // Only closing is taken from the window, everything else is recorded
         sf::Event event;
-        while (State::get().gameWindow.pollEvent(event)) {
-            switch (event.type) {
-                case sf::Event::Closed:
-                    State::get().gameWindow.close();
-                    break;
-                case sf::Event::Resized:
-                    updateFrameScale();
-                    break;
-                case sf::Event::MouseButtonPressed:
-                    switch (event.mouseButton.button) {
-                        case sf::Mouse::Left:
-                            State::get().leftClick = true;
-                            break;
-                        case sf::Mouse::Right:
-                            State::get().rightClick = true;
-                            break;
-                        default:
-                            break;
-                    }
-                    break;
-                case sf::Event::MouseWheelScrolled:
-                    State::get().scrollDelta
-                        = event.mouseWheelScroll.delta;
-                    break;
-                case sf::Event::KeyPressed:
-                    State::get().setKeyPressedStatus(event.key.code, true);
-                    break;
-                default:
-                    break;
+        auto& window = State::get().gameWindow;
+        while (window && window->pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                quit();
             }
         }
 
         updateState();
-        renderFrame();
 
+        State::get().clearFrameInput();
         State::get().lastMousePosition = State::get().mousePosition;
+
+        // The frame is as the step left it, with nothing to interpolate
+        if (m_offscreen) {
+            State::get().interpolate(0.f);
+            composeFrame();
+        }
+
+        // Each step counts as a frame, as at most one is composed per step
+        State::get().profiler.endFrame(stepClock.restart());
+        State::get().renderStats.endFrame();
+        checkAllocations();
+    }
+
+    log_info("Replayed " + std::to_string(index) + " steps in " +
+             std::to_string(clock.getElapsedTime().asMilliseconds()) + " ms");
+
+    // Nothing reports while replaying, so the statistics cover every step
+    if (!m_statsPath.empty()) {
+        writeStatistics(m_statsPath);
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void Game::updateState()
 {
+    profile_scope("Game::updateState");
     State::get().update();
 
     if (State::get().getKeyStatus(Key::Esc)) {
-        State::get().gameWindow.close();
+        quit();
     }
 
     static bool showDebug = true;
     if (State::get().getKeyPressedStatus(Key::D)) {
         State::get().showDebug = showDebug;
         showDebug = !showDebug;
+
+        // The bounds of the text depend on its glyphs
+        if (!State::get().headless) {
+            State::get().frameCompositor.addDamage(
+                State::get().debugManager->getBounds());
+        }
+    }
+
+    if (State::get().getKeyPressedStatus(Key::T)) {
+        writeTrace("requested");
+    }
+
+    if (State::get().getKeyPressedStatus(Key::P)) {
+        writeStatistics("stats-" + std::to_string(time(nullptr)) + "-" +
+                        std::to_string(++m_statsCount) + ".csv");
     }
 
     // TODO: Remove this
@@ -371,39 +609,143 @@ void Game::updateState()
 ///////////////////////////////////////////////////////////////////////////////
 void Game::renderFrame()
 {
-    State::get().frameBuffer.clear();
-    State::get().frameBuffer.draw(State::get());
-    State::get().frameBuffer.display();
+    profile_scope("Game::renderFrame");
+
+    composeFrame();
+
+    // Frames are submitted even when nothing changed, so that waiting on
+    // the render thread paces this loop to the display
+    profile_scope("RenderThread::submit");
+    m_renderThread.submit(State::get().frameBuffer->getTexture(),
+                          State::get().frameScale, m_windowSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Game::composeFrame()
+{
+    profile_scope("FrameCompositor::compose");
+
+    // Only the regions damaged since the last frame are redrawn, the rest
+    // of the frame buffer still holds the last frame
+    State::get().frameCompositor.compose(*State::get().frameBuffer,
+                                         State::get());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Game::checkBaseline()
+{
+    if (m_baselinePath.empty()) {
+        return true;
+    }
+
+    PerformanceBaseline baseline;
+    PerformanceBaseline current;
+    if (!baseline.loadFromFile(m_baselinePath) ||
+        !current.loadFromFile(m_statsPath)) {
+        log_warn("Could not compare with the baseline: " + m_baselinePath);
+        return false;
+    }
+
+    auto regressions = current.compare(baseline, m_tolerance);
+    if (regressions) {
+        log_warn(std::to_string(regressions) +
+                 " times regressed from the baseline: " + m_baselinePath);
+        return false;
+    }
+
+    log_info("No times regressed from the baseline: " + m_baselinePath);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Game::writeTrace(const std::string& reason)
+{
+    auto path = "trace-" + std::to_string(time(nullptr)) + "-" +
+                std::to_string(++m_traceCount) + ".json";
 
-    sf::Sprite frameSprite(State::get().frameBuffer.getTexture());
-    frameSprite.setScale(State::get().frameScale);
+    auto zones = State::get().profiler.writeTrace(path);
+    if (zones >= 0) {
+        log_info("Wrote " + std::to_string(zones) + " zones to " + path +
+                 " (" + reason + ")");
+    }
+
+    m_sinceTrace = sf::Time::Zero;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Game::writeStatistics(const std::string& path)
+{
+    if (State::get().profiler.writeStatistics(path)) {
+        log_info("Wrote profiler statistics to " + path);
+    }
+}
 
-    //State::get().gameWindow.clear();
-    State::get().gameWindow.draw(frameSprite);
-    State::get().gameWindow.display();
+///////////////////////////////////////////////////////////////////////////////
+void Game::checkAllocations()
+{
+    if (!m_checkAllocations) {
+        return;
+    }
+    else if (m_allocationWarmup) {
+        --m_allocationWarmup;
+        return;
+    }
+
+    auto& profiler = State::get().profiler;
+    const auto& allocations = profiler.getFrameAllocations();
+    if (!allocations.allocations) {
+        return;
+    }
+
+    // Zones include the allocations of the zones in them, so the innermost
+    // zone named is where to look
+    std::string zones;
+    for (const auto& zone : profiler.getFrameZones()) {
+        if (zone.allocations.allocations) {
+            zones += "\n    " + std::string(zone.name) + ": " +
+                     std::to_string(zone.allocations.allocations) + " (" +
+                     std::to_string(zone.allocations.bytes) + " bytes)";
+        }
+    }
+
+    log_exit("Frame made " + std::to_string(allocations.allocations) +
+             " allocations (" + std::to_string(allocations.bytes) +
+             " bytes) after warming up" +
+             (zones.empty() ? " outside of any zone" : ", in zones:" + zones));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Game::quit()
+{
+    m_running = false;
+    m_renderThread.stop();
+
+    if (State::get().gameWindow) {
+        State::get().gameWindow->close();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void Game::updateFrameScale()
+void Game::updateFrameScale(const sf::Vector2u& windowSize)
 {
-    State::get().frameScale.x =
-        static_cast<float>(State::get().gameWindow.getSize().x)
-        / static_cast<float>(State::get().frameSize.x);
-    State::get().frameScale.y =
-        static_cast<float>(State::get().gameWindow.getSize().y)
-        / static_cast<float>(State::get().frameSize.y);
+    m_windowSize = windowSize;
+    State::get().frameScale.x = static_cast<float>(windowSize.x)
+                                / static_cast<float>(State::get().frameSize.x);
+    State::get().frameScale.y = static_cast<float>(windowSize.y)
+                                / static_cast<float>(State::get().frameSize.y);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void Game::updateFrameMouseCoord()
 {
-    sf::Vector2f windowPosition = State::get().gameWindow.mapPixelToCoords(
-        sf::Mouse::getPosition(State::get().gameWindow));
+    // The render thread draws with a view of the window's pixels, and owns
+    // the window's view, so pixels are mapped without it
+    auto windowPosition = sf::Mouse::getPosition(*State::get().gameWindow);
 
     State::get().mousePosition = sf::Vector2i(
-        static_cast<int>(std::round(
-            windowPosition.x / State::get().frameScale.x)),
-        static_cast<int>(std::round(
-            windowPosition.y / State::get().frameScale.y))
+        static_cast<int>(std::round(static_cast<float>(windowPosition.x)
+                                    / State::get().frameScale.x)),
+        static_cast<int>(std::round(static_cast<float>(windowPosition.y)
+                                    / State::get().frameScale.y))
     );
 }
@@ -15,6 +15,10 @@
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 
+#include "RenderThread.hpp"
+#include "InputRecording.hpp"
+#include "PerformanceBaseline.hpp"
+
 ///////////////////////////////////////////////////////////////////////////////
 /// @class  Game
 /// @brief  Highest level class representing a game
@@ -39,6 +43,72 @@ public:
             sf::Vector2u size;
         } frame;
 
+        ///////////////////////////////////////////////////////////////////////
+        /// The simulation advances in steps of stepMs, however fast frames
+        /// are rendered. After a hitch, at most maxSteps steps are run before
+        /// the next frame and the rest are dropped.
+        ///////////////////////////////////////////////////////////////////////
+        struct {
+            sf::Int32 stepMs;
+            sf::Uint32 maxSteps;
+        } simulation;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// seed is ignored when replaying, as the recording's seed is used,
+        /// and scripts may set their own. Empty paths disable recording,
+        /// replaying and scripts. Scripts are played back like replays.
+        ///
+        /// If statsPath isn't empty, the profiler's frame and zone time
+        /// percentiles are written to it as CSV once the game ends.
+        ///
+        /// When headless, no window is opened and the window settings are
+        /// ignored. The input must then come from a replay or script. When
+        /// offscreen, replays and scripts compose each step's frame into the
+        /// frame buffer, which is never shown, so rendering is timed too.
+        ///////////////////////////////////////////////////////////////////////
+        struct {
+            sf::Uint32 seed;
+            std::string recordPath;
+            std::string replayPath;
+            std::string scriptPath;
+            std::string statsPath;
+            bool headless;
+            bool offscreen;
+        } session;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// If path isn't empty, the statistics a replay or script writes to
+        /// the session's statsPath are compared with those in path, from an
+        /// earlier run of the same session, and times which regressed beyond
+        /// the tolerance fail the run.
+        ///////////////////////////////////////////////////////////////////////
+        struct {
+            std::string path;
+            PerformanceBaseline::Tolerance tolerance;
+        } baseline;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// The profiler's zones of the last seconds are kept for traces,
+        /// which are written when T is pressed, and when a frame takes longer
+        /// than slowFrameMs unless it is 0. Slow frames don't write another
+        /// trace until the last one's zones have all been replaced. P writes
+        /// the profiler's time percentiles to a new CSV file.
+        ///////////////////////////////////////////////////////////////////////
+        struct {
+            sf::Uint32 seconds;
+            sf::Int32 slowFrameMs;
+        } trace;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// When check is set, every frame after the first warmupFrames must
+        /// make no allocations, or the game exits naming the zones which
+        /// did. This needs allocations to be tracked.
+        ///////////////////////////////////////////////////////////////////////
+        struct {
+            bool check;
+            sf::Uint32 warmupFrames;
+        } allocations;
+
         Settings() = delete;
     };
 
@@ -56,32 +126,98 @@ public:
 
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Begin the main game loop
+    ///
+    /// Frames are rendered as fast as the window allows, and the simulation
+    /// steps as often as needed to keep up with real time in between.
+    ///
+    /// When replaying or running a script, its steps are played back
+    /// instead, and the game returns once they run out. When recording, the
+    /// recording is written once the game window is closed.
+    ///
+    /// @return False if the replay's times regressed from the baseline,
+    ///         true otherwise
     ///////////////////////////////////////////////////////////////////////////
-    void play();
+    bool play();
 
 private:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Plays back the recorded steps as fast as they can be run
+    ///
+    /// Each step's recorded deltaMs, mouse position and input events are
+    /// used in place of the clock and the window's, and frames aren't
+    /// rendered, since only the resulting game state matters. This is all
+    /// a headless game does.
+    ///////////////////////////////////////////////////////////////////////////
+    void replay();
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates the game state
     ///
-    /// This should be called once per frame.
+    /// This should be called once per simulation step.
     ///////////////////////////////////////////////////////////////////////////
     void updateState();
 
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Renders the current frame
     ///
-    /// This should be called once per frame.
+    /// The frame is composed on this thread and handed to the render thread
+    /// to be presented. This should be called once per frame.
     ///////////////////////////////////////////////////////////////////////////
     void renderFrame();
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Redraws the damaged regions of the frame buffer
+    ///////////////////////////////////////////////////////////////////////////
+    void composeFrame();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Compares the statistics written by a replay with the baseline
+    ///
+    /// @return False if any time regressed, true otherwise or if there is no
+    ///         baseline
+    ///////////////////////////////////////////////////////////////////////////
+    bool checkBaseline();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the profiler's recent zones to a new trace file
+    ///
+    /// @param reason   Why the trace is written, which is logged
+    ///////////////////////////////////////////////////////////////////////////
+    void writeTrace(const std::string& reason);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the profiler's time percentiles to a CSV file
+    ///
+    /// @param path Path of the file
+    ///////////////////////////////////////////////////////////////////////////
+    void writeStatistics(const std::string& path);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Exits if the last frame allocated, once warmed up
+    ///
+    /// This should be called after the profiler's endFrame(), and does
+    /// nothing unless allocations are being checked.
+    ///////////////////////////////////////////////////////////////////////////
+    void checkAllocations();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Ends the game loop
+    ///
+    /// The render thread is stopped and the game window closed, if there is
+    /// one.
+    ///////////////////////////////////////////////////////////////////////////
+    void quit();
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates the frame scale factor
     ///
     /// This should be called when the once initially and then again whenever
     /// the window is resized.
+    ///
+    /// @param windowSize   New size of the window
     ///////////////////////////////////////////////////////////////////////////
-    void updateFrameScale();
+    void updateFrameScale(const sf::Vector2u& windowSize);
 
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates the global State's mouse coordinate
@@ -91,6 +227,25 @@ private:
     void updateFrameMouseCoord();
 
     ///////////////////////////////////////////////////////////////////////////
+    sf::Int32 m_stepMs;
+    sf::Uint32 m_maxSteps;
+    RenderThread m_renderThread;
+    sf::Vector2u m_windowSize;
+    InputRecording m_recording;
+    std::string m_recordPath;
+    std::string m_statsPath;
+    std::string m_baselinePath;
+    PerformanceBaseline::Tolerance m_tolerance;
+    bool m_replaying = false;
+    bool m_offscreen = false;
+    bool m_running = true;
+    sf::Time m_traceLength;
+    sf::Time m_slowFrame;
+    sf::Time m_sinceTrace;
+    sf::Uint32 m_traceCount = 0;
+    sf::Uint32 m_statsCount = 0;
+    bool m_checkAllocations;
+    sf::Uint32 m_allocationWarmup;
 };
 
 #endif
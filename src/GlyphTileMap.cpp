@@ -8,6 +8,55 @@
 #include "State.hpp"
 #include "GlyphTileMap.hpp"
 
+#include <cmath>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+/// Appends the part of a quad inside a region, its texture coordinates cut
+/// down along with its corners. Quads are axis aligned, from the top left
+/// corner clockwise.
+///////////////////////////////////////////////////////////////////////////////
+static void appendClipped(const sf::Vertex* quad, const sf::FloatRect& region,
+                          std::vector<sf::Vertex>& vertices)
+{
+    const auto& from = quad[0];
+    const auto& to = quad[2];
+
+    auto left = std::max(from.position.x, region.left);
+    auto top = std::max(from.position.y, region.top);
+    auto right = std::min(to.position.x, region.left + region.width);
+    auto bottom = std::min(to.position.y, region.top + region.height);
+
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    // Backgrounds map every corner to the same texel
+    auto texCoord = [](float position, float start, float end,
+                       float texStart, float texEnd) {
+        return end > start ? texStart + (position - start) / (end - start) *
+                                 (texEnd - texStart)
+                           : texStart;
+    };
+    auto texLeft = texCoord(left, from.position.x, to.position.x,
+                            from.texCoords.x, to.texCoords.x);
+    auto texRight = texCoord(right, from.position.x, to.position.x,
+                             from.texCoords.x, to.texCoords.x);
+    auto texTop = texCoord(top, from.position.y, to.position.y,
+                           from.texCoords.y, to.texCoords.y);
+    auto texBottom = texCoord(bottom, from.position.y, to.position.y,
+                              from.texCoords.y, to.texCoords.y);
+
+    vertices.emplace_back(sf::Vector2f(left, top), from.color,
+                          sf::Vector2f(texLeft, texTop));
+    vertices.emplace_back(sf::Vector2f(right, top), from.color,
+                          sf::Vector2f(texRight, texTop));
+    vertices.emplace_back(sf::Vector2f(right, bottom), from.color,
+                          sf::Vector2f(texRight, texBottom));
+    vertices.emplace_back(sf::Vector2f(left, bottom), from.color,
+                          sf::Vector2f(texLeft, texBottom));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 GlyphTileMap::Tile::Tile()
     : type(Type::Center),
@@ -55,6 +104,7 @@ void GlyphTileMap::create(sf::Font& font,
     m_foreground.resize(area.x * area.y * 4);
     m_background.setPrimitiveType(sf::Quads);
     m_background.resize(area.x * area.y * 4);
+    ++m_version;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -75,11 +125,31 @@ sf::Uint32 GlyphTileMap::getCharSize() const
     return m_charSize;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+const sf::Texture& GlyphTileMap::getTexture() const
+{
+    return m_font.getTexture(m_charSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 GlyphTileMap::getVersion() const
+{
+    return m_version;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const GlyphTileMap::Tile& GlyphTileMap::getTile(
+    const sf::Vector2u& coord) const
+{
+    return m_tiles[getIndex(coord)];
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void GlyphTileMap::setTile(const sf::Vector2u& coord, const Tile& tile)
 {
     updateTile(coord, tile);
     m_tiles[getIndex(coord)] = tile;
+    ++m_version;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -91,6 +161,7 @@ void GlyphTileMap::setTileCharacter(const sf::Vector2u& coord,
     updateCharacter(coord, character, type, offset);
     m_tiles[getIndex(coord)].character = character;
     m_tiles[getIndex(coord)].type = type;
+    ++m_version;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -102,6 +173,7 @@ void GlyphTileMap::setTileColors(const sf::Vector2u& coord,
     updateBgColor(coord, background);
     m_tiles[getIndex(coord)].foreground = foreground;
     m_tiles[getIndex(coord)].background = background;
+    ++m_version;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -110,6 +182,7 @@ void GlyphTileMap::setTileFgColor(const sf::Vector2u& coord,
 {
     updateFgColor(coord, color);
     m_tiles[getIndex(coord)].foreground = color;
+    ++m_version;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -118,6 +191,7 @@ void GlyphTileMap::setTileBgColor(const sf::Vector2u& coord,
 {
     updateBgColor(coord, color);
     m_tiles[getIndex(coord)].background = color;
+    ++m_version;
 }
 
 
@@ -198,29 +272,118 @@ sf::Vector2i GlyphTileMap::getTileCoordFromPosition(
 ///////////////////////////////////////////////////////////////////////////////
 void GlyphTileMap::update()
 {
+    profile_scope("GlyphTileMap::update");
     auto deltaMs = State::get().deltaMs;
+    auto rows = std::max(AnimateGrain / std::max(m_area.x, 1u), 1u);
+    auto chunks = (m_area.y + rows - 1) / rows;
+
+    if (m_animated.size() < chunks) {
+        m_animated.resize(chunks);
+    }
+
+    // Each chunk of rows lists the tiles whose appearance it changed, so
+    // that only their vertices are touched and the version stays put for
+    // idle animations
+    State::get().jobSystem.parallelFor(0, m_area.y, rows,
+        [this, deltaMs, rows](sf::Uint32 begin, sf::Uint32 end) {
+            profile_scope("GlyphTileMap::animate");
+            auto& changed = m_animated[begin / rows];
+            changed.clear();
+
+            for (auto index = begin * m_area.x; index < end * m_area.x;
+                 ++index) {
+                auto& tile = m_tiles[index];
+                if (!tile.animation) {
+                    continue;
+                }
+
+                auto character = tile.character;
+                auto type = tile.type;
+                auto offset = tile.offset;
+                auto foreground = tile.foreground;
+                auto background = tile.background;
+
+                tile.animation(tile, deltaMs);
+
+                if (tile.character != character || tile.type != type ||
+                    tile.offset != offset || tile.foreground != foreground ||
+                    tile.background != background) {
+                    changed.push_back(index);
+                }
+            }
+        });
+
+    for (sf::Uint32 chunk = 0; chunk < chunks; ++chunk) {
+        for (auto index : m_animated[chunk]) {
+            updateTile({index % m_area.x, index / m_area.x}, m_tiles[index]);
+            ++m_version;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 GlyphTileMap::getOverhang() const
+{
+    return m_overhang;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void GlyphTileMap::appendRegion(const sf::FloatRect& region,
+                                std::vector<sf::Vertex>& vertices) const
+{
+    auto overhang = static_cast<float>(m_overhang);
+    auto spacing = sf::Vector2f(m_spacing);
+
+    // The tiles whose characters may reach into the region
+    auto first = [overhang](float edge, float size) {
+        return static_cast<sf::Uint32>(
+            std::max((edge - overhang) / size, 0.f));
+    };
+    auto last = [overhang](float edge, float size, sf::Uint32 count) {
+        return std::min(static_cast<sf::Uint32>(
+            std::max(std::ceil((edge + overhang) / size), 0.f)), count);
+    };
+
+    auto left = first(region.left, spacing.x);
+    auto top = first(region.top, spacing.y);
+    auto right = last(region.left + region.width, spacing.x, m_area.x);
+    auto bottom = last(region.top + region.height, spacing.y, m_area.y);
 
-    // Important: This relies on the layout of m_tiles, but should be a lot
-    // faster than calling getIndex() for every animated tile in every map
-    for (sf::Uint32 x = 0; x < m_area.x; ++x) {
-        for (sf::Uint32 y = 0; y < m_area.y; ++y) {
-            auto index = getIndex({x, y});
-            if (m_tiles[index].animation) {
-                m_tiles[index].animation(m_tiles[index], deltaMs);
-                updateTile({x, y}, m_tiles[index]);
+    for (const auto* layer : {&m_background, &m_foreground}) {
+        for (auto y = top; y < bottom; ++y) {
+            for (auto x = left; x < right; ++x) {
+                appendClipped(&(*layer)[getIndex({x, y}) * 4], region,
+                              vertices);
             }
         }
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void GlyphTileMap::appendVertices(std::vector<sf::Vertex>& vertices,
+                                  const sf::Transform& transform) const
+{
+    auto combined = transform * getTransform();
+
+    for (const auto* layer : {&m_background, &m_foreground}) {
+        for (std::size_t i = 0; i < layer->getVertexCount(); ++i) {
+            auto vertex = (*layer)[i];
+            vertex.position = combined.transformPoint(vertex.position);
+            vertices.push_back(vertex);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void GlyphTileMap::draw(sf::RenderTarget& target,
                         sf::RenderStates states) const
 {
     states.transform *= getTransform();
     states.texture = &m_font.getTexture(m_charSize);
-    target.draw(m_background, states);
-    target.draw(m_foreground, states);
+
+    auto& renderStats = State::get().renderStats;
+    renderStats.draw(target, m_background, states);
+    renderStats.draw(target, m_foreground, states);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -271,6 +434,11 @@ sf::Vector2i GlyphTileMap::getOffset(const sf::Glyph& glyph,
 void GlyphTileMap::updateTile(const sf::Vector2u& coord,
                               const Tile& tile)
 {
+    // Looking up a glyph renders it to the font's texture
+    if (State::get().headless) {
+        return;
+    }
+
     const sf::Glyph& glyph = m_font.getGlyph(tile.character,
                                              m_charSize,
                                              false);
@@ -289,6 +457,10 @@ void GlyphTileMap::updateCharacter(const sf::Vector2u& coord,
                                    Tile::Type type,
                                    const sf::Vector2i& offset)
 {
+    if (State::get().headless) {
+        return;
+    }
+
     const sf::Glyph& glyph = m_font.getGlyph(character,
                                              m_charSize,
                                              false);
@@ -305,6 +477,16 @@ void GlyphTileMap::updateFgPosition(const sf::Vector2u& coord,
 {
     sf::Uint32 index = getIndex(coord) * 4;
 
+    // Characters wider or taller than the spacing overhang their tiles
+    auto reach = std::max({-offset.x, -offset.y,
+                           offset.x + texRect.width -
+                               static_cast<int>(m_spacing.x),
+                           offset.y + texRect.height -
+                               static_cast<int>(m_spacing.y)});
+    if (reach > static_cast<int>(m_overhang)) {
+        m_overhang = static_cast<sf::Uint32>(reach);
+    }
+
     m_foreground[index].position = {
         static_cast<float>(static_cast<int>(coord.x * m_spacing.x) + offset.x),
         static_cast<float>(static_cast<int>(coord.y * m_spacing.y) + offset.y)
@@ -41,7 +41,9 @@ public:
         /// @brief The Animation function type is used for the update callback
         ///
         /// This should be some self-contained lambda that takes a Tile
-        /// reference and a delta time value and updates the Tile's appearance
+        /// reference and a delta time value and updates the Tile's appearance.
+        /// Animations of different tiles run at the same time, so they must
+        /// not change anything but the Tile they are given.
         ///////////////////////////////////////////////////////////////////////
         typedef std::function<void(GlyphTileMap::Tile&, sf::Int32)> Animation;
 
@@ -146,6 +148,32 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     sf::Uint32 getCharSize() const;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the font texture used to draw the GlyphTileMap
+    ///
+    /// @return the font texture for the character size of the GlyphTileMap
+    ///////////////////////////////////////////////////////////////////////////
+    const sf::Texture& getTexture() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number which changes whenever the tiles' appearance
+    ///        does
+    ///
+    /// This is never 0, so callers may use 0 to mean "nothing drawn yet".
+    ///
+    /// @return Version of the GlyphTileMap's vertices
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint64 getVersion() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a const reference to the Tile at a coord
+    ///
+    /// @param coord    Coordinate in the GlyphTileMap of the Tile
+    ///
+    /// @return a const reference to the Tile at coord
+    ///////////////////////////////////////////////////////////////////////////
+    const Tile& getTile(const sf::Vector2u& coord) const;
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates the GlyphTileMap at a coord with data from a Tile
     ///
@@ -249,12 +277,58 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates all the contained Tiles
     ///
-    /// Should be called once per frame
+    /// Should be called once per frame. The version only changes if an
+    /// animation actually changed the appearance of a Tile. Animations run
+    /// in parallel over chunks of rows on the State's JobSystem, and the
+    /// vertices of the Tiles they changed are then rebuilt on the calling
+    /// thread, as looking glyphs up in the font is not thread-safe.
     ///////////////////////////////////////////////////////////////////////////
     void update();
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns how far characters reach outside of their tiles
+    ///
+    /// @return Most pixels any character has reached past its tile's edges
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getOverhang() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends the untransformed vertices of a region, clipped to it
+    ///
+    /// The backgrounds and then the characters of every tile reaching into
+    /// the region are appended, cut down to the part inside it. Drawing the
+    /// vertices as quads with the texture returned by getTexture() repaints
+    /// the region exactly as draw() would, including characters overhanging
+    /// it from neighboring tiles, so a region can be redrawn (e.g. into a
+    /// persistent buffer) without touching anything around it.
+    ///
+    /// @param region   Region in the GlyphTileMap's local pixels
+    /// @param vertices Vertex buffer to append the quads to
+    ///////////////////////////////////////////////////////////////////////////
+    void appendRegion(const sf::FloatRect& region,
+                      std::vector<sf::Vertex>& vertices) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends the vertices of every tile, transformed for drawing
+    ///
+    /// All of the background quads are appended before all of the foreground
+    /// quads, so drawing the vertices as quads with the texture returned by
+    /// getTexture() looks the same as draw(). This allows several
+    /// GlyphTileMaps to be drawn with a single draw call.
+    ///
+    /// @param vertices     Vertex buffer to append the quads to
+    /// @param transform    Transform to apply on top of the GlyphTileMap's own
+    ///////////////////////////////////////////////////////////////////////////
+    void appendVertices(std::vector<sf::Vertex>& vertices,
+                        const sf::Transform& transform) const;
+
 private:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of tiles animated per job in update()
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 AnimateGrain = 4096;
+
     ///////////////////////////////////////////////////////////////////////////
     /// Overloaded draw function from sf::Drawable/sf::Transformable
     ///////////////////////////////////////////////////////////////////////////
@@ -351,6 +425,9 @@ private:
     std::vector<Tile> m_tiles;
     sf::VertexArray m_foreground;
     sf::VertexArray m_background;
+    sf::Uint64 m_version = 1;
+    sf::Uint32 m_overhang = 0;
+    std::vector<std::vector<sf::Uint32>> m_animated;
 };
 
 #endif
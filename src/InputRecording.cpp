@@ -0,0 +1,482 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   InputRecording.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Recorded seed and per-frame input of a session, for replays
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputRecording.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void InputRecording::clear(sf::Uint32 seed)
+{
+    m_seed = seed;
+    m_frames.clear();
+    m_events.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 InputRecording::getSeed() const
+{
+    return m_seed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void InputRecording::addFrame(sf::Int32 deltaMs,
+                              const sf::Vector2i& mousePosition,
+                              const std::vector<InputEvent>& events)
+{
+    m_frames.push_back({deltaMs, mousePosition,
+                        static_cast<sf::Uint32>(m_events.size()),
+                        static_cast<sf::Uint32>(events.size())});
+    m_events.insert(m_events.end(), events.begin(), events.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 InputRecording::getFrameCount() const
+{
+    return static_cast<sf::Uint32>(m_frames.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const InputRecording::Frame& InputRecording::getFrame(sf::Uint32 index) const
+{
+    if (index >= m_frames.size()) {
+        log_exit("Frame index out of range: " + std::to_string(index));
+    }
+
+    return m_frames[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const InputEvent* InputRecording::getEvents(const Frame& frame) const
+{
+    return m_events.data() + frame.firstEvent;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::saveToFile(const std::string& path) const
+{
+    std::vector<sf::Uint8> bytes(FileMagic, FileMagic + sizeof(FileMagic));
+    bytes.push_back(FileVersion);
+
+    writeVarint(bytes, m_seed);
+    writeVarint(bytes, m_frames.size());
+
+    sf::Vector2i lastPosition;
+    sf::Int64 lastTime = 0;
+
+    for (const auto& frame : m_frames) {
+        writeSigned(bytes, frame.deltaMs);
+        writeSigned(bytes, frame.mousePosition.x - lastPosition.x);
+        writeSigned(bytes, frame.mousePosition.y - lastPosition.y);
+        writeVarint(bytes, frame.eventCount);
+        lastPosition = frame.mousePosition;
+
+        auto events = getEvents(frame);
+        for (sf::Uint32 i = 0; i < frame.eventCount; ++i) {
+            const auto& event = events[i];
+
+            writeSigned(bytes, event.time - lastTime);
+            writeVarint(bytes, event.type);
+            lastTime = event.time;
+
+            switch (event.type) {
+                case InputEvent::KeyPressed:
+                case InputEvent::KeyReleased:
+                    writeVarint(bytes, static_cast<sf::Uint64>(event.key));
+                    break;
+                case InputEvent::MousePressed:
+                case InputEvent::MouseReleased:
+                    writeVarint(bytes, static_cast<sf::Uint64>(event.button));
+                    break;
+                case InputEvent::Scrolled: {
+                    sf::Uint32 bits;
+                    std::memcpy(&bits, &event.delta, sizeof(bits));
+                    writeVarint(bytes, bits);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+
+    if (!file) {
+        log_warn("Could not write input recording: " + path);
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        log_warn("Could not open input recording: " + path);
+        clear(0);
+        return false;
+    }
+
+    std::vector<sf::Uint8> bytes((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+
+    if (!parse(bytes)) {
+        log_warn("Invalid input recording: " + path);
+        clear(0);
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::loadFromScript(const std::string& path, sf::Uint32 seed,
+                                    sf::Int32 deltaMs)
+{
+    std::ifstream file(path);
+    clear(seed);
+
+    if (!file) {
+        log_warn("Could not open input script: " + path);
+        return false;
+    }
+
+    sf::Uint32 line = 0;
+    if (!compile(file, deltaMs, line)) {
+        log_warn("Invalid input script command at " + path + ":" +
+                 std::to_string(line));
+        clear(0);
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void InputRecording::writeVarint(std::vector<sf::Uint8>& bytes,
+                                 sf::Uint64 value)
+{
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<sf::Uint8>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<sf::Uint8>(value));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void InputRecording::writeSigned(std::vector<sf::Uint8>& bytes,
+                                 sf::Int64 value)
+{
+    // Zigzag encoding, so small negative values stay small
+    auto bits = static_cast<sf::Uint64>(value);
+    writeVarint(bytes, value < 0 ? ~(bits << 1) : bits << 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::readVarint(const std::vector<sf::Uint8>& bytes,
+                                std::size_t& offset, sf::Uint64& value)
+{
+    value = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (offset >= bytes.size()) {
+            return false;
+        }
+
+        auto byte = bytes[offset++];
+        value |= static_cast<sf::Uint64>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::readSigned(const std::vector<sf::Uint8>& bytes,
+                                std::size_t& offset, sf::Int64& value)
+{
+    sf::Uint64 bits;
+
+    if (!readVarint(bytes, offset, bits)) {
+        return false;
+    }
+
+    value = static_cast<sf::Int64>(bits & 1 ? ~(bits >> 1) : bits >> 1);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::parse(const std::vector<sf::Uint8>& bytes)
+{
+    std::size_t offset = sizeof(FileMagic) + 1;
+
+    if (bytes.size() < offset ||
+        std::memcmp(bytes.data(), FileMagic, sizeof(FileMagic)) != 0 ||
+        bytes[sizeof(FileMagic)] != FileVersion) {
+        return false;
+    }
+
+    sf::Uint64 seed;
+    sf::Uint64 frameCount;
+
+    if (!readVarint(bytes, offset, seed) ||
+        !readVarint(bytes, offset, frameCount) ||
+        seed > 0xFFFFFFFF) {
+        return false;
+    }
+
+    clear(static_cast<sf::Uint32>(seed));
+
+    sf::Vector2i lastPosition;
+    sf::Int64 lastTime = 0;
+
+    for (sf::Uint64 i = 0; i < frameCount; ++i) {
+        sf::Int64 deltaMs;
+        sf::Int64 dx;
+        sf::Int64 dy;
+        sf::Uint64 eventCount;
+
+        if (!readSigned(bytes, offset, deltaMs) ||
+            !readSigned(bytes, offset, dx) ||
+            !readSigned(bytes, offset, dy) ||
+            !readVarint(bytes, offset, eventCount) ||
+            eventCount > bytes.size() - offset) {
+            return false;
+        }
+
+        lastPosition.x += static_cast<int>(dx);
+        lastPosition.y += static_cast<int>(dy);
+        m_frames.push_back({static_cast<sf::Int32>(deltaMs), lastPosition,
+                            static_cast<sf::Uint32>(m_events.size()),
+                            static_cast<sf::Uint32>(eventCount)});
+
+        for (sf::Uint64 j = 0; j < eventCount; ++j) {
+            InputEvent event = {0, InputEvent::KeyPressed, Key::Count,
+                                MouseButton::Count, 0.f};
+            sf::Int64 time;
+            sf::Uint64 type;
+            sf::Uint64 value = 0;
+
+            if (!readSigned(bytes, offset, time) ||
+                !readVarint(bytes, offset, type) ||
+                type >= InputEvent::Count) {
+                return false;
+            }
+
+            lastTime += time;
+            event.time = lastTime;
+            event.type = static_cast<InputEvent::Type>(type);
+
+            switch (event.type) {
+                case InputEvent::KeyPressed:
+                case InputEvent::KeyReleased:
+                    if (!readVarint(bytes, offset, value) ||
+                        value >= static_cast<sf::Uint64>(Key::Count)) {
+                        return false;
+                    }
+                    event.key = static_cast<Key>(value);
+                    break;
+                case InputEvent::MousePressed:
+                case InputEvent::MouseReleased:
+                    if (!readVarint(bytes, offset, value) ||
+                        value >= static_cast<sf::Uint64>(MouseButton::Count)) {
+                        return false;
+                    }
+                    event.button = static_cast<MouseButton>(value);
+                    break;
+                case InputEvent::Scrolled: {
+                    if (!readVarint(bytes, offset, value) ||
+                        value > 0xFFFFFFFF) {
+                        return false;
+                    }
+                    auto bits = static_cast<sf::Uint32>(value);
+                    std::memcpy(&event.delta, &bits, sizeof(bits));
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            m_events.push_back(event);
+        }
+    }
+
+    return offset == bytes.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::compile(std::istream& script, sf::Int32 deltaMs,
+                             sf::Uint32& line)
+{
+    // Events of the current step, and those deferred to the next one
+    std::vector<InputEvent> events;
+    std::vector<InputEvent> deferred;
+    sf::Vector2i mousePosition;
+    sf::Int64 time = 0;
+
+    auto endStep = [&]() {
+        addFrame(deltaMs, mousePosition, events);
+        time += static_cast<sf::Int64>(deltaMs) * 1000;
+        events.swap(deferred);
+        deferred.clear();
+
+        for (auto& event : events) {
+            event.time = time;
+        }
+    };
+
+    auto input = [&](InputEvent::Type type, Key key, MouseButton button,
+                     float delta, std::vector<InputEvent>& to) {
+        to.push_back({time, type, key, button, delta});
+    };
+
+    std::string text;
+    for (line = 1; std::getline(script, text); ++line) {
+        std::istringstream words(text.substr(0, text.find('#')));
+        std::string command;
+        std::string name;
+        Key key;
+        MouseButton button;
+
+        if (!(words >> command)) {
+            continue;
+        }
+
+        if (command == "seed") {
+            if (!(words >> m_seed)) {
+                return false;
+            }
+        }
+        else if (command == "wait") {
+            sf::Int64 steps;
+            if (!(words >> steps)) {
+                if (!words.eof()) {
+                    return false;
+                }
+                words.clear();
+                steps = 1;
+            }
+            if (steps < 1) {
+                return false;
+            }
+            for (sf::Int64 i = 0; i < steps; ++i) {
+                endStep();
+            }
+        }
+        else if (command == "press" || command == "release" ||
+                 command == "tap") {
+            if (!(words >> name) || !parseKey(name, key)) {
+                return false;
+            }
+            input(command == "release" ? InputEvent::KeyReleased
+                                       : InputEvent::KeyPressed,
+                  key, MouseButton::Count, 0.f, events);
+            if (command == "tap") {
+                input(InputEvent::KeyReleased, key, MouseButton::Count, 0.f,
+                      deferred);
+            }
+        }
+        else if (command == "mousedown" || command == "mouseup" ||
+                 command == "click") {
+            if (!(words >> name) || !parseButton(name, button)) {
+                return false;
+            }
+            input(command == "mouseup" ? InputEvent::MouseReleased
+                                       : InputEvent::MousePressed,
+                  Key::Count, button, 0.f, events);
+            if (command == "click") {
+                input(InputEvent::MouseReleased, Key::Count, button, 0.f,
+                      deferred);
+            }
+        }
+        else if (command == "mouse") {
+            if (!(words >> mousePosition.x >> mousePosition.y)) {
+                return false;
+            }
+        }
+        else if (command == "scroll") {
+            float delta;
+            if (!(words >> delta)) {
+                return false;
+            }
+            input(InputEvent::Scrolled, Key::Count, MouseButton::Count, delta,
+                  events);
+        }
+        else {
+            return false;
+        }
+
+        // Anything after a command's arguments is a mistake
+        if (words >> name) {
+            return false;
+        }
+    }
+
+    while (!events.empty() || !deferred.empty()) {
+        endStep();
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::parseKey(const std::string& name, Key& key)
+{
+    static const char* const names[] = {
+        "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N",
+        "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "Num0",
+        "Num1", "Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8",
+        "Num9", "Esc", "Ctrl", "Shift", "Alt", "Space", "Left", "Right", "Up",
+        "Down"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) ==
+                  static_cast<std::size_t>(Key::Count),
+                  "Every key needs a name");
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Key::Count); ++i) {
+        if (name == names[i]) {
+            key = static_cast<Key>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool InputRecording::parseButton(const std::string& name,
+                                 MouseButton& button)
+{
+    if (name == "left") {
+        button = MouseButton::Left;
+    }
+    else if (name == "right") {
+        button = MouseButton::Right;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
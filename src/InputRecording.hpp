@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   InputRecording.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Recorded seed and per-frame input of a session, for replays
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__INPUT_RECORDING_HPP
+#define ROGUELIKE__INPUT_RECORDING_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <SFML/System.hpp>
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Recorded seed and per-frame input of a session, for replays
+///
+/// Everything the game reads from outside during a simulation step is
+/// recorded as a frame: the step's deltaMs, the mouse position and the input
+/// events the step received. Given the same seed, feeding these back in
+/// frame by frame plays the session out exactly as it happened, without
+/// waiting on the clock.
+///
+/// Files are compact: numbers are stored as variable-length integers, mouse
+/// positions and event times relative to the previous ones, and a frame
+/// without input takes only a few bytes.
+///////////////////////////////////////////////////////////////////////////////
+class InputRecording {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A recorded frame, whose events are in getEvents()
+    ///////////////////////////////////////////////////////////////////////////
+    struct Frame {
+        sf::Int32 deltaMs;
+        sf::Vector2i mousePosition;
+        sf::Uint32 firstEvent;
+        sf::Uint32 eventCount;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    InputRecording() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    InputRecording(const InputRecording&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const InputRecording&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes all frames and sets the seed of the session
+    ///
+    /// @param seed Seed the session's Random was started from
+    ///////////////////////////////////////////////////////////////////////////
+    void clear(sf::Uint32 seed);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the seed of the session
+    ///
+    /// @return The seed
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getSeed() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Records a frame
+    ///
+    /// @param deltaMs          The frame's deltaMs
+    /// @param mousePosition    The frame's mouse position
+    /// @param events           The input events received during the frame
+    ///////////////////////////////////////////////////////////////////////////
+    void addFrame(sf::Int32 deltaMs, const sf::Vector2i& mousePosition,
+                  const std::vector<InputEvent>& events);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of recorded frames
+    ///
+    /// @return Number of frames
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getFrameCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a recorded frame
+    ///
+    /// @param index    Index of the frame, in the order they were recorded
+    ///
+    /// @return The frame
+    ///////////////////////////////////////////////////////////////////////////
+    const Frame& getFrame(sf::Uint32 index) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the input events of a frame
+    ///
+    /// @param frame    A frame returned by getFrame()
+    ///
+    /// @return Pointer to frame.eventCount events, in the order received
+    ///////////////////////////////////////////////////////////////////////////
+    const InputEvent* getEvents(const Frame& frame) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the recording to a file
+    ///
+    /// @param path Path of the file
+    ///
+    /// @return True if the file was written, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool saveToFile(const std::string& path) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Replaces the recording with one read from a file
+    ///
+    /// @param path Path of the file
+    ///
+    /// @return True if the file was read, false if it could not be opened or
+    ///         is not a valid recording, leaving the recording empty
+    ///////////////////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& path);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Replaces the recording with one compiled from an input script
+    ///
+    /// Scripts are text files of one command per line, with '#' starting a
+    /// comment. Commands add input to the current step until it is ended:
+    ///
+    ///     seed <n>            Use n as the seed of the session
+    ///     wait [n]            End the current step, then run n - 1 more
+    ///     press <key>         Press a key, named as in the Key enum
+    ///     release <key>       Release a key
+    ///     tap <key>           Press a key, and release it in the next step
+    ///     mouse <x> <y>       Move the mouse to a position in the frame
+    ///     mousedown <button>  Press the left or right mouse button
+    ///     mouseup <button>    Release a mouse button
+    ///     click <button>      Press a button, and release it in the next step
+    ///     scroll <delta>      Scroll the mouse wheel
+    ///
+    /// Input left at the end of the script is given a last step.
+    ///
+    /// @param path     Path of the script
+    /// @param seed     Seed of the session, unless the script sets one
+    /// @param deltaMs  deltaMs of every step
+    ///
+    /// @return True if the script was read, false if it could not be opened
+    ///         or has an invalid command, leaving the recording empty
+    ///////////////////////////////////////////////////////////////////////////
+    bool loadFromScript(const std::string& path, sf::Uint32 seed,
+                        sf::Int32 deltaMs);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Signature at the start of recording files
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr char FileMagic[4] = {'R', 'L', 'I', 'R'};
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Format version following the signature
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint8 FileVersion = 1;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends a variable-length unsigned integer
+    ///
+    /// @param bytes    Buffer to append to
+    /// @param value    Value to append
+    ///////////////////////////////////////////////////////////////////////////
+    static void writeVarint(std::vector<sf::Uint8>& bytes, sf::Uint64 value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends a variable-length signed integer
+    ///
+    /// @param bytes    Buffer to append to
+    /// @param value    Value to append
+    ///////////////////////////////////////////////////////////////////////////
+    static void writeSigned(std::vector<sf::Uint8>& bytes, sf::Int64 value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reads a variable-length unsigned integer
+    ///
+    /// @param bytes    Buffer to read from
+    /// @param offset   Offset to read at, moved past the integer
+    /// @param value    Set to the value read
+    ///
+    /// @return False if the buffer ends before the integer does
+    ///////////////////////////////////////////////////////////////////////////
+    static bool readVarint(const std::vector<sf::Uint8>& bytes,
+                           std::size_t& offset, sf::Uint64& value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reads a variable-length signed integer
+    ///
+    /// @param bytes    Buffer to read from
+    /// @param offset   Offset to read at, moved past the integer
+    /// @param value    Set to the value read
+    ///
+    /// @return False if the buffer ends before the integer does
+    ///////////////////////////////////////////////////////////////////////////
+    static bool readSigned(const std::vector<sf::Uint8>& bytes,
+                           std::size_t& offset, sf::Int64& value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reads the recording from the contents of a file
+    ///
+    /// @param bytes    Contents of the file
+    ///
+    /// @return False if the contents are not a valid recording
+    ///////////////////////////////////////////////////////////////////////////
+    bool parse(const std::vector<sf::Uint8>& bytes);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reads the recording from the commands of an input script
+    ///
+    /// @param script   The script, positioned at its first line
+    /// @param deltaMs  deltaMs of every step
+    /// @param line     Set to the number of the line being read
+    ///
+    /// @return False if a command is invalid
+    ///////////////////////////////////////////////////////////////////////////
+    bool compile(std::istream& script, sf::Int32 deltaMs, sf::Uint32& line);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Looks up a key by its name in the Key enum
+    ///
+    /// @param name Name of the key, such as "A", "Num1" or "Esc"
+    /// @param key  Set to the key
+    ///
+    /// @return False if no key has the name
+    ///////////////////////////////////////////////////////////////////////////
+    static bool parseKey(const std::string& name, Key& key);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Looks up a mouse button by name
+    ///
+    /// @param name     "left" or "right"
+    /// @param button   Set to the button
+    ///
+    /// @return False if no button has the name
+    ///////////////////////////////////////////////////////////////////////////
+    static bool parseButton(const std::string& name, MouseButton& button);
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 m_seed = 0;
+    std::vector<Frame> m_frames;
+    std::vector<InputEvent> m_events;
+};
+
+#endif
@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   JobSystem.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Work-stealing scheduler running jobs on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Common.hpp"
+#include "Profiler.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Index of the calling thread, which is 0 unless it is a worker
+///////////////////////////////////////////////////////////////////////////////
+static thread_local sf::Uint32 threadIndex = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobSystem::TaskGroup::isDone() const
+{
+    return m_pending.load(std::memory_order_acquire) == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobSystem::JobSystem(sf::Uint32 workerCount)
+{
+    for (sf::Uint32 i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (sf::Uint32 i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::work, this, i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 JobSystem::getDefaultWorkerCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 JobSystem::getThreadCount() const
+{
+    return static_cast<sf::Uint32>(m_queues.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 JobSystem::getThreadIndex()
+{
+    return threadIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobSystem::wait(TaskGroup& group)
+{
+    Job job;
+
+    while (!group.isDone()) {
+        if (take(job)) {
+            execute(job);
+        }
+        else {
+            // The rest of the group is running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobSystem::push(const Job& job)
+{
+    if (threadIndex >= m_queues.size()) {
+        log_exit("Job pushed from another JobSystem's worker");
+    }
+
+    job.group->m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    auto& queue = *m_queues[threadIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.count < QueueSize) {
+            queue.jobs[(queue.first + queue.count) % QueueSize] = job;
+            ++queue.count;
+            m_queued.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+
+    // A full queue has plenty for the other threads to do, and growing it
+    // would allocate
+    wake();
+    execute(job);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobSystem::wake()
+{
+    if (m_workers.empty()) {
+        return;
+    }
+
+    // Taking the lock orders this with a worker checking for jobs, so the
+    // wakeup can't slip in between its check and its wait
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_all();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool JobSystem::take(Job& job)
+{
+    if (!m_queued.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    auto count = static_cast<sf::Uint32>(m_queues.size());
+
+    // The newest of our own jobs, or else the oldest of someone else's
+    for (sf::Uint32 i = 0; i < count; ++i) {
+        auto index = (threadIndex + i) % count;
+        auto& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.count) {
+            continue;
+        }
+
+        if (i == 0) {
+            job = queue.jobs[(queue.first + queue.count - 1) % QueueSize];
+        }
+        else {
+            job = queue.jobs[queue.first];
+            queue.first = (queue.first + 1) % QueueSize;
+        }
+        --queue.count;
+
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobSystem::execute(const Job& job)
+{
+    job.function(job.data, job.begin, job.end);
+    job.group->m_pending.fetch_sub(1, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void JobSystem::work(sf::Uint32 index)
+{
+    threadIndex = index;
+    Profiler::setThreadName("Worker");
+    Job job;
+
+    while (true) {
+        if (take(job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] {
+            return m_queued.load(std::memory_order_acquire) || m_stopping;
+        });
+
+        if (m_stopping && !m_queued.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,295 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   JobSystem.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Work-stealing scheduler running jobs on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__JOB_SYSTEM_HPP
+#define ROGUELIKE__JOB_SYSTEM_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Work-stealing scheduler running jobs on a pool of worker threads
+///
+/// Every worker has its own queue of jobs. Jobs are pushed onto the queue of
+/// the thread creating them, and each thread takes its own jobs newest first,
+/// while idle threads steal from the others oldest first, so threads mostly
+/// work on their own recent (cache-warm) jobs and only contend when stealing.
+/// Threads which aren't workers, such as the main thread, share one extra
+/// queue. A thread waiting on a TaskGroup runs jobs itself until the group
+/// is done, so waiting never wastes a thread, and the pool can have no
+/// workers at all, in which case jobs run inside wait().
+///
+/// Jobs refer to the callable they run rather than copying it, and queues
+/// are rings of QueueSize jobs allocated up front, so nothing is allocated
+/// per job. A job pushed onto a full queue is run right away instead, by the
+/// thread pushing it. The callable must outlive the wait for its group.
+/// Jobs must not depend on the order they run in: anything shared must only
+/// be read, or be written at disjoint indices.
+///////////////////////////////////////////////////////////////////////////////
+class JobSystem {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of jobs each thread's queue holds
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 QueueSize = 1 << 10;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A set of jobs which can be waited on together
+    ///
+    /// A job run in a group happens before anything following a wait() on
+    /// the group, which is how dependencies between jobs are expressed.
+    ///////////////////////////////////////////////////////////////////////////
+    class TaskGroup {
+    public:
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Default constructor
+        ///////////////////////////////////////////////////////////////////////
+        TaskGroup() = default;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable copy constructor
+        ///////////////////////////////////////////////////////////////////////
+        TaskGroup(const TaskGroup&) = delete;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable assignment operator
+        ///////////////////////////////////////////////////////////////////////
+        void operator=(const TaskGroup&) = delete;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Returns whether every job in the group has finished
+        ///
+        /// @return True if no job in the group is queued or running
+        ///////////////////////////////////////////////////////////////////////
+        bool isDone() const;
+
+    private:
+
+        friend class JobSystem;
+
+        ///////////////////////////////////////////////////////////////////////
+        std::atomic<sf::Uint32> m_pending{0};
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///
+    /// @param workerCount  Number of worker threads to start
+    ///////////////////////////////////////////////////////////////////////////
+    explicit JobSystem(sf::Uint32 workerCount = getDefaultWorkerCount());
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Destructor, which finishes queued jobs and stops the workers
+    ///////////////////////////////////////////////////////////////////////////
+    ~JobSystem();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    JobSystem(const JobSystem&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const JobSystem&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns one less than the number of hardware threads
+    ///
+    /// The thread creating jobs makes up the difference, as it runs jobs
+    /// while it waits.
+    ///
+    /// @return Default number of workers
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint32 getDefaultWorkerCount();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of threads which can run jobs at once
+    ///
+    /// @return Number of workers, plus one for the threads which aren't
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getThreadCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the calling thread
+    ///
+    /// Jobs can use this to pick per-thread scratch data.
+    ///
+    /// @return 0 for threads which aren't workers, or the worker's index
+    ///         plus one, always less than getThreadCount()
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint32 getThreadIndex();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Queues a job which calls a function
+    ///
+    /// @param group    Group to add the job to
+    /// @param function Callable taking no arguments, which must outlive the
+    ///                 wait for the group
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void run(TaskGroup& group, Function& function);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs queued jobs until every job in a group has finished
+    ///
+    /// @param group    Group to wait for
+    ///////////////////////////////////////////////////////////////////////////
+    void wait(TaskGroup& group);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls a function over the chunks of a range in parallel
+    ///
+    /// The range is split into chunks of grain indices, the last of which
+    /// may be smaller, and this returns once the function has been called
+    /// for every chunk. Ranges no larger than a chunk are run directly.
+    ///
+    /// @param begin    First index of the range
+    /// @param end      One past the last index of the range
+    /// @param grain    Number of indices per chunk, which should be large
+    ///                 enough for a chunk to outweigh the cost of a job
+    /// @param function Callable taking the begin and end (sf::Uint32) of a
+    ///                 chunk
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void parallelFor(sf::Uint32 begin, sf::Uint32 end, sf::Uint32 grain,
+                     const Function& function);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A queued call of a function over a range
+    ///////////////////////////////////////////////////////////////////////////
+    struct Job {
+        void (*function)(void* data, sf::Uint32 begin, sf::Uint32 end);
+        void* data;
+        sf::Uint32 begin;
+        sf::Uint32 end;
+        TaskGroup* group;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Ring of the jobs queued by a thread
+    ///
+    /// The jobs queued are the count from first on, wrapping around, so
+    /// either end can be taken from.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Job> jobs = std::vector<Job>(QueueSize);
+        sf::Uint32 first = 0;
+        sf::Uint32 count = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a job to its group and to the calling thread's queue
+    ///
+    /// Workers aren't woken until wake() is called, so that a batch of jobs
+    /// only wakes them once. If the queue is full, the workers are woken to
+    /// work through it and the job is run right away.
+    ///
+    /// @param job  Job to queue
+    ///////////////////////////////////////////////////////////////////////////
+    void push(const Job& job);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Wakes the sleeping workers
+    ///////////////////////////////////////////////////////////////////////////
+    void wake();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Takes a job from the calling thread's queue, or steals one
+    ///
+    /// @param job  Set to the job taken
+    ///
+    /// @return False if every queue was empty
+    ///////////////////////////////////////////////////////////////////////////
+    bool take(Job& job);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs a job and marks it finished in its group
+    ///
+    /// @param job  Job to run
+    ///////////////////////////////////////////////////////////////////////////
+    static void execute(const Job& job);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs jobs until the scheduler is destroyed, on a worker thread
+    ///
+    /// @param index    Thread index of the worker
+    ///////////////////////////////////////////////////////////////////////////
+    void work(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<sf::Uint32> m_queued{0};
+    bool m_stopping = false;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Template implementation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void JobSystem::run(TaskGroup& group, Function& function)
+{
+    push({
+        [](void* data, sf::Uint32, sf::Uint32) {
+            (*static_cast<Function*>(data))();
+        },
+        &function, 0, 0, &group
+    });
+    wake();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void JobSystem::parallelFor(sf::Uint32 begin, sf::Uint32 end,
+                            sf::Uint32 grain, const Function& function)
+{
+    grain = std::max(grain, 1u);
+
+    if (end <= begin) {
+        return;
+    }
+    else if (end - begin <= grain || m_workers.empty()) {
+        function(begin, end);
+        return;
+    }
+
+    auto call = [](void* data, sf::Uint32 chunkBegin, sf::Uint32 chunkEnd) {
+        (*static_cast<const Function*>(data))(chunkBegin, chunkEnd);
+    };
+
+    TaskGroup group;
+    for (auto chunk = begin; chunk < end;) {
+        auto chunkEnd = chunk + std::min(grain, end - chunk);
+        push({call, const_cast<Function*>(&function), chunk, chunkEnd,
+              &group});
+        chunk = chunkEnd;
+    }
+
+    wake();
+    wait(group);
+}
+
+#endif
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   LayerAtlas.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Pool of render texture pages divided into regions for caching
+///         rendered layers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LayerAtlas.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+LayerAtlas::LayerAtlas() : m_freeRegions(SizeCount * SizeCount) {}
+
+///////////////////////////////////////////////////////////////////////////////
+LayerAtlas::Region LayerAtlas::allocate(const sf::Vector2u& size)
+{
+    if (size.x > PageSize || size.y > PageSize) {
+        return Region();
+    }
+
+    auto sizeClass = (getSizeIndex(size.x) * SizeCount) +
+                     getSizeIndex(size.y);
+    auto& freeRegions = m_freeRegions[sizeClass];
+
+    if (freeRegions.empty() && !addPage(sizeClass)) {
+        return Region();
+    }
+
+    auto region = freeRegions.back();
+    freeRegions.pop_back();
+
+    return region;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LayerAtlas::release(Region& region)
+{
+    if (region.page != None) {
+        m_freeRegions[region.sizeClass].push_back(region);
+        region = Region();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool LayerAtlas::fits(const Region& region, const sf::Vector2u& size)
+{
+    return region.page != None &&
+           static_cast<sf::Uint32>(region.rect.width) >= size.x &&
+           static_cast<sf::Uint32>(region.rect.height) >= size.y;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::RenderTarget& LayerAtlas::beginDraw(const Region& region)
+{
+    if (region.page >= m_pages.size()) {
+        log_exit("Region is not allocated");
+    }
+
+    auto& page = *m_pages[region.page];
+    auto pageSize = static_cast<float>(PageSize);
+    auto width = static_cast<float>(region.rect.width);
+    auto height = static_cast<float>(region.rect.height);
+
+    sf::View view(sf::FloatRect(0.f, 0.f, width, height));
+    view.setViewport(sf::FloatRect(
+        static_cast<float>(region.rect.left) / pageSize,
+        static_cast<float>(region.rect.top) / pageSize,
+        width / pageSize,
+        height / pageSize));
+    page.setView(view);
+
+    // Replace (rather than blend over) the previous contents of the region
+    sf::Vertex clear[] = {
+        sf::Vertex({0.f, 0.f}, sf::Color::Transparent),
+        sf::Vertex({width, 0.f}, sf::Color::Transparent),
+        sf::Vertex({width, height}, sf::Color::Transparent),
+        sf::Vertex({0.f, height}, sf::Color::Transparent)
+    };
+    State::get().renderStats.draw(page, clear, 4, sf::Quads,
+                                  sf::RenderStates(sf::BlendNone));
+
+    m_drawnPages[region.page] = true;
+
+    return page;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LayerAtlas::endDraw()
+{
+    for (sf::Uint32 i = 0; i < m_pages.size(); ++i) {
+        if (m_drawnPages[i]) {
+            m_pages[i]->display();
+            m_drawnPages[i] = false;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const sf::Texture& LayerAtlas::getTexture(sf::Uint32 page) const
+{
+    if (page >= m_pages.size()) {
+        log_exit("Page does not exist: " + std::to_string(page));
+    }
+
+    return m_pages[page]->getTexture();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 LayerAtlas::getSizeIndex(sf::Uint32 size)
+{
+    sf::Uint32 index = 0;
+    while ((MinRegionSize << index) < size) {
+        ++index;
+    }
+
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool LayerAtlas::addPage(sf::Uint32 sizeClass)
+{
+    if (m_pages.size() >= MaxPages) {
+        return false;
+    }
+
+    std::unique_ptr<sf::RenderTexture> page(new sf::RenderTexture());
+    if (!page->create(PageSize, PageSize)) {
+        log_warn("Could not create layer atlas page");
+        return false;
+    }
+    page->clear(sf::Color::Transparent);
+
+    auto index = static_cast<sf::Uint32>(m_pages.size());
+    m_pages.push_back(std::move(page));
+    m_drawnPages.push_back(true);
+
+    // Hand out regions from the top-left of the page first
+    auto width = MinRegionSize << (sizeClass / SizeCount);
+    auto height = MinRegionSize << (sizeClass % SizeCount);
+    auto& freeRegions = m_freeRegions[sizeClass];
+
+    for (auto y = PageSize; y >= height; y -= height) {
+        for (auto x = PageSize; x >= width; x -= width) {
+            Region region;
+            region.page = index;
+            region.sizeClass = sizeClass;
+            region.rect = {static_cast<int>(x - width),
+                           static_cast<int>(y - height),
+                           static_cast<int>(width),
+                           static_cast<int>(height)};
+            freeRegions.push_back(region);
+        }
+    }
+
+    return true;
+}
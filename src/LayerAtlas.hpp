@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   LayerAtlas.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Pool of render texture pages divided into regions for caching
+///         rendered layers
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__LAYER_ATLAS_HPP
+#define ROGUELIKE__LAYER_ATLAS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Pool of render texture pages divided into regions for caching
+///        rendered layers
+///
+/// Regions are rounded up to power of two widths and heights (size classes),
+/// and each page is divided evenly into regions of a single size class when
+/// it is first needed. Released regions go back onto a free list for their
+/// size class, so once the pages for the layers in use exist, allocating and
+/// releasing regions never allocates and never creates textures. Pages are
+/// kept for the lifetime of the LayerAtlas.
+///////////////////////////////////////////////////////////////////////////////
+class LayerAtlas {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Width and height of a page in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 PageSize = 1024;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Smallest width and height of a region in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MinRegionSize = 32;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Maximum number of pages, past which allocation fails
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MaxPages = 16;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Page of a region which was not allocated
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 None = 0xFFFFFFFF;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief An area of a page
+    ///////////////////////////////////////////////////////////////////////////
+    struct Region {
+        sf::Uint32 page = None;
+        sf::Uint32 sizeClass = 0;
+        sf::IntRect rect;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    LayerAtlas();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    LayerAtlas(const LayerAtlas&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const LayerAtlas&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Allocates a region at least as large as a size
+    ///
+    /// @param size Width and height of the region in pixels
+    ///
+    /// @return The region, whose page is None if the size is larger than a
+    ///         page or no more pages could be created
+    ///////////////////////////////////////////////////////////////////////////
+    Region allocate(const sf::Vector2u& size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a region to the pool
+    ///
+    /// @param region   The region, which may be unallocated
+    ///////////////////////////////////////////////////////////////////////////
+    void release(Region& region);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether a region is at least as large as a size
+    ///
+    /// @param region   The region
+    /// @param size     Width and height in pixels
+    ///
+    /// @return True if the region is allocated and fits the size
+    ///////////////////////////////////////////////////////////////////////////
+    static bool fits(const Region& region, const sf::Vector2u& size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Clears a region and prepares its page to be drawn into
+    ///
+    /// The page's view is set so that only the region can be drawn to, with
+    /// the region's top-left corner at the origin.
+    ///
+    /// @param region   The region to draw into
+    ///
+    /// @return The page of the region
+    ///////////////////////////////////////////////////////////////////////////
+    sf::RenderTarget& beginDraw(const Region& region);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Finishes drawing into the pages drawn to since the last call
+    ///
+    /// This should be called once after drawing into any number of regions,
+    /// and before the regions are drawn from.
+    ///////////////////////////////////////////////////////////////////////////
+    void endDraw();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the texture of a page
+    ///
+    /// @param page Index of the page
+    ///
+    /// @return Texture of the page
+    ///////////////////////////////////////////////////////////////////////////
+    const sf::Texture& getTexture(sf::Uint32 page) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of power of two sizes from MinRegionSize to PageSize
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 SizeCount = 6;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the smallest power of two size >= a size
+    ///
+    /// @param size Width or height in pixels, no larger than PageSize
+    ///
+    /// @return Index of the size, 0 being MinRegionSize
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint32 getSizeIndex(sf::Uint32 size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates a page and divides it into regions of a size class
+    ///
+    /// @param sizeClass    Size class of the page's regions
+    ///
+    /// @return False if the page could not be created
+    ///////////////////////////////////////////////////////////////////////////
+    bool addPage(sf::Uint32 sizeClass);
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<std::unique_ptr<sf::RenderTexture>> m_pages;
+    std::vector<bool> m_drawnPages;
+    std::vector<std::vector<Region>> m_freeRegions;
+};
+
+#endif
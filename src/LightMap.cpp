@@ -0,0 +1,377 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   LightMap.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Incrementally propagates colored light from sources across an
+///         opacity grid
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightMap.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include "State.hpp"
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::create(const sf::Vector2u& area)
+{
+    m_area = area;
+    m_levels.assign(area.x * area.y, Level());
+    m_opaque.assign(area.x * area.y, 0);
+    m_dirtyFlags.assign(area.x * area.y, 0);
+    m_sources.clear();
+    m_pending.clear();
+    m_freeIds.clear();
+    m_dirtyTiles.clear();
+    m_scratches.clear();
+
+    for (sf::Uint32 i = 0; i < area.x * area.y; ++i) {
+        markDirty(i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::setAmbient(const sf::Color& ambient)
+{
+    m_ambient = ambient;
+
+    for (sf::Uint32 i = 0; i < m_area.x * m_area.y; ++i) {
+        markDirty(i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::setOpaque(const sf::Vector2u& coord, bool opaque)
+{
+    auto index = (coord.y * m_area.x) + coord.x;
+
+    if ((m_opaque[index] != 0) == opaque) {
+        return;
+    }
+
+    m_opaque[index] = opaque ? 1 : 0;
+
+    for (LightId id = 0; id < m_sources.size(); ++id) {
+        const auto& source = m_sources[id];
+        if (!source.active) {
+            continue;
+        }
+
+        auto dx = static_cast<sf::Int64>(coord.x) - source.light.position.x;
+        auto dy = static_cast<sf::Int64>(coord.y) - source.light.position.y;
+        auto radius = static_cast<sf::Int64>(source.light.radius);
+
+        if (std::abs(dx) <= radius && std::abs(dy) <= radius) {
+            markPending(id, true);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool LightMap::isOpaque(const sf::Vector2u& coord) const
+{
+    return m_opaque[(coord.y * m_area.x) + coord.x] != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+LightMap::LightId LightMap::addLight(const Light& light)
+{
+    if (light.position.x >= m_area.x || light.position.y >= m_area.y) {
+        log_exit("Light position is outside of the LightMap");
+    }
+
+    LightId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else {
+        id = static_cast<LightId>(m_sources.size());
+        m_sources.emplace_back();
+    }
+
+    auto& source = m_sources[id];
+    source.light = light;
+    source.active = true;
+    source.appliedIntensity = 0;
+    source.footprint.clear();
+    markPending(id, true);
+
+    return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::removeLight(LightId id)
+{
+    if (id >= m_sources.size() || !m_sources[id].active) {
+        log_warn("Light does not exist: " + std::to_string(id));
+        return;
+    }
+
+    auto& source = m_sources[id];
+    accumulate(source, -1);
+    source.footprint.clear();
+    source.active = false;
+    m_freeIds.push_back(id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::setLightPosition(LightId id, const sf::Vector2u& position)
+{
+    checkLight(id);
+
+    if (position.x >= m_area.x || position.y >= m_area.y) {
+        log_exit("Light position is outside of the LightMap");
+    }
+
+    if (m_sources[id].light.position != position) {
+        m_sources[id].light.position = position;
+        markPending(id, true);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::setLightColor(LightId id, const sf::Color& color)
+{
+    checkLight(id);
+
+    if (m_sources[id].light.color != color) {
+        m_sources[id].light.color = color;
+        markPending(id, false);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::setLightIntensity(LightId id, sf::Uint8 intensity)
+{
+    checkLight(id);
+
+    if (m_sources[id].light.intensity != intensity) {
+        m_sources[id].light.intensity = intensity;
+        markPending(id, false);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const LightMap::Light& LightMap::getLight(LightId id) const
+{
+    checkLight(id);
+
+    return m_sources[id].light;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::update()
+{
+    profile_scope("LightMap::update");
+    m_propagating.clear();
+
+    for (auto id : m_pending) {
+        auto& source = m_sources[id];
+        source.pending = false;
+
+        // Removed after being queued
+        if (!source.active) {
+            continue;
+        }
+
+        accumulate(source, -1);
+        if (source.repropagate) {
+            m_propagating.push_back(id);
+        }
+    }
+
+    // Every old contribution is gone before any footprint is replaced, and
+    // the new ones are only added once every footprint is done
+    auto& jobSystem = State::get().jobSystem;
+    m_scratches.resize(jobSystem.getThreadCount());
+
+    jobSystem.parallelFor(
+        0, static_cast<sf::Uint32>(m_propagating.size()), PropagateGrain,
+        [this](sf::Uint32 begin, sf::Uint32 end) {
+            profile_scope("LightMap::propagate");
+            auto& scratch = m_scratches[JobSystem::getThreadIndex()];
+            for (auto i = begin; i < end; ++i) {
+                propagate(m_sources[m_propagating[i]], scratch);
+            }
+        });
+
+    for (auto id : m_pending) {
+        auto& source = m_sources[id];
+        if (!source.active) {
+            continue;
+        }
+
+        source.repropagate = false;
+        source.appliedColor = source.light.color;
+        source.appliedIntensity = source.light.intensity;
+        accumulate(source, 1);
+    }
+
+    m_pending.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<sf::Uint32>& LightMap::getDirtyTiles() const
+{
+    return m_dirtyTiles;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::clearDirtyTiles()
+{
+    for (auto index : m_dirtyTiles) {
+        m_dirtyFlags[index] = 0;
+    }
+
+    m_dirtyTiles.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Color LightMap::getLevel(sf::Uint32 index) const
+{
+    const auto& level = m_levels[index];
+
+    return sf::Color(
+        static_cast<sf::Uint8>(std::min(m_ambient.r + level.r, 255)),
+        static_cast<sf::Uint8>(std::min(m_ambient.g + level.g, 255)),
+        static_cast<sf::Uint8>(std::min(m_ambient.b + level.b, 255))
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Color LightMap::shade(sf::Uint32 index, const sf::Color& color) const
+{
+    auto level = getLevel(index);
+
+    return sf::Color(
+        static_cast<sf::Uint8>(std::min(color.r * level.r / Neutral, 255)),
+        static_cast<sf::Uint8>(std::min(color.g * level.g / Neutral, 255)),
+        static_cast<sf::Uint8>(std::min(color.b * level.b / Neutral, 255)),
+        color.a
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::checkLight(LightId id) const
+{
+    if (id >= m_sources.size() || !m_sources[id].active) {
+        log_exit("Light does not exist: " + std::to_string(id));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::markPending(LightId id, bool repropagate)
+{
+    auto& source = m_sources[id];
+    source.repropagate = source.repropagate || repropagate;
+
+    if (!source.pending) {
+        source.pending = true;
+        m_pending.push_back(id);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::accumulate(const Source& source, sf::Int32 sign)
+{
+    // Contributions are recomputed from the applied (not the current) values
+    // so that subtracting exactly cancels out the earlier addition
+    sf::Int32 r = source.appliedColor.r * source.appliedIntensity;
+    sf::Int32 g = source.appliedColor.g * source.appliedIntensity;
+    sf::Int32 b = source.appliedColor.b * source.appliedIntensity;
+
+    for (const auto& lit : source.footprint) {
+        auto& level = m_levels[lit.index];
+        level.r += sign * ((r * lit.level) / (255 * 255));
+        level.g += sign * ((g * lit.level) / (255 * 255));
+        level.b += sign * ((b * lit.level) / (255 * 255));
+        markDirty(lit.index);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::propagate(Source& source, Scratch& scratch) const
+{
+    source.footprint.clear();
+
+    auto& visited = scratch.visited;
+    auto& queue = scratch.queue;
+
+    if (visited.size() != m_area.x * m_area.y) {
+        visited.assign(m_area.x * m_area.y, 0);
+        scratch.stamp = 0;
+    }
+
+    if (++scratch.stamp == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        scratch.stamp = 1;
+    }
+
+    auto origin = sf::Vector2i(source.light.position);
+    auto radius = static_cast<int>(source.light.radius);
+    auto radiusSq = static_cast<float>(radius * radius);
+
+    queue.clear();
+    queue.push_back((source.light.position.y * m_area.x) +
+                    source.light.position.x);
+    visited[queue.front()] = scratch.stamp;
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        auto index = queue[head];
+        auto x = static_cast<int>(index % m_area.x);
+        auto y = static_cast<int>(index / m_area.x);
+        auto distanceSq = static_cast<float>(
+            (x - origin.x) * (x - origin.x) + (y - origin.y) * (y - origin.y));
+
+        auto falloff = 1.0f - (std::sqrt(distanceSq) /
+                               static_cast<float>(radius + 1));
+        source.footprint.push_back({
+            index, static_cast<sf::Uint8>(255.0f * falloff * falloff)
+        });
+
+        // Walls are lit but do not let light through, except at the source
+        if (m_opaque[index] && head != 0) {
+            continue;
+        }
+
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto nx = x + dx;
+                auto ny = y + dy;
+
+                if (nx < 0 || ny < 0 ||
+                    nx >= static_cast<int>(m_area.x) ||
+                    ny >= static_cast<int>(m_area.y)) {
+                    continue;
+                }
+
+                auto neighborSq = static_cast<float>(
+                    (nx - origin.x) * (nx - origin.x) +
+                    (ny - origin.y) * (ny - origin.y));
+                auto neighbor = static_cast<sf::Uint32>(ny) * m_area.x +
+                                static_cast<sf::Uint32>(nx);
+
+                if (neighborSq <= radiusSq &&
+                    visited[neighbor] != scratch.stamp) {
+                    visited[neighbor] = scratch.stamp;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void LightMap::markDirty(sf::Uint32 index)
+{
+    if (!m_dirtyFlags[index]) {
+        m_dirtyFlags[index] = 1;
+        m_dirtyTiles.push_back(index);
+    }
+}
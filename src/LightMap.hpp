@@ -0,0 +1,302 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   LightMap.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Incrementally propagates colored light from sources across an
+///         opacity grid
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__LIGHT_MAP_HPP
+#define ROGUELIKE__LIGHT_MAP_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Propagates colored light across an opacity grid
+///
+/// Each light caches the tiles it reaches (its footprint) along with its last
+/// applied color and intensity. When a light changes only its own footprint
+/// is subtracted from and re-added to the accumulated light levels, and only
+/// lights whose radius covers a changed wall are re-propagated. The tiles
+/// whose light level changed are collected so that the owner can re-shade
+/// just those tiles. Footprints don't depend on each other, so lights being
+/// re-propagated are flood filled in parallel on the State's JobSystem.
+///////////////////////////////////////////////////////////////////////////////
+class LightMap {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Handle used to refer to a light after it has been added
+    ///////////////////////////////////////////////////////////////////////////
+    typedef sf::Uint32 LightId;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Light level that leaves a shaded color unchanged
+    ///
+    /// Light levels above this brighten a color, levels below darken it.
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Int32 Neutral = 64;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @struct LightMap::Light
+    /// @brief  Describes a single light source
+    ///////////////////////////////////////////////////////////////////////////
+    struct Light {
+        sf::Vector2u position;
+        sf::Color color;
+        sf::Uint32 radius;
+        sf::Uint8 intensity;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor, create() must be called before use
+    ///////////////////////////////////////////////////////////////////////////
+    LightMap() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    LightMap(const LightMap&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const LightMap&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief (Re)creates the LightMap with every tile transparent and unlit
+    ///
+    /// @param area Width and height of the LightMap in # of tiles
+    ///////////////////////////////////////////////////////////////////////////
+    void create(const sf::Vector2u& area);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Sets the light level of tiles not reached by any light
+    ///
+    /// This marks every tile as dirty.
+    ///
+    /// @param ambient  New ambient light level
+    ///////////////////////////////////////////////////////////////////////////
+    void setAmbient(const sf::Color& ambient);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Sets whether or not a tile blocks light
+    ///
+    /// Lights whose radius covers the tile are re-propagated on update().
+    ///
+    /// @param coord    Coordinate of the tile
+    /// @param opaque   True if the tile blocks light
+    ///////////////////////////////////////////////////////////////////////////
+    void setOpaque(const sf::Vector2u& coord, bool opaque);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not a tile blocks light
+    ///
+    /// @param coord    Coordinate of the tile
+    ///
+    /// @return True if the tile blocks light, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool isOpaque(const sf::Vector2u& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a new light, which is propagated on update()
+    ///
+    /// @param light    Description of the new light
+    ///
+    /// @return Handle to the new light
+    ///////////////////////////////////////////////////////////////////////////
+    LightId addLight(const Light& light);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a light
+    ///
+    /// @param id   Handle of the light to remove
+    ///////////////////////////////////////////////////////////////////////////
+    void removeLight(LightId id);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves a light, which is re-propagated on update()
+    ///
+    /// @param id       Handle of the light to move
+    /// @param position New position of the light
+    ///////////////////////////////////////////////////////////////////////////
+    void setLightPosition(LightId id, const sf::Vector2u& position);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Changes the color of a light without re-propagating it
+    ///
+    /// @param id       Handle of the light to update
+    /// @param color    New color of the light
+    ///////////////////////////////////////////////////////////////////////////
+    void setLightColor(LightId id, const sf::Color& color);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Changes the intensity of a light without re-propagating it
+    ///
+    /// This is cheap enough to be called every frame (e.g. for flickering).
+    ///
+    /// @param id           Handle of the light to update
+    /// @param intensity    New intensity of the light
+    ///////////////////////////////////////////////////////////////////////////
+    void setLightIntensity(LightId id, sf::Uint8 intensity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the description of a light
+    ///
+    /// @param id   Handle of the light
+    ///
+    /// @return Description of the light
+    ///////////////////////////////////////////////////////////////////////////
+    const Light& getLight(LightId id) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Applies all pending light and opacity changes
+    ///
+    /// Tiles whose light level changed are appended to the dirty tiles.
+    ///////////////////////////////////////////////////////////////////////////
+    void update();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the indices of tiles whose light level has changed
+    ///
+    /// Indices are (y * area.x) + x, matching the GlyphTileMap layout.
+    ///
+    /// @return Indices of tiles changed since the last clearDirtyTiles()
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<sf::Uint32>& getDirtyTiles() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Clears the list of dirty tiles
+    ///////////////////////////////////////////////////////////////////////////
+    void clearDirtyTiles();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the total light level at a tile
+    ///
+    /// @param index    Index of the tile
+    ///
+    /// @return Ambient plus accumulated light, clamped to 255 per channel
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Color getLevel(sf::Uint32 index) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Modulates a color by the light level at a tile
+    ///
+    /// @param index    Index of the tile
+    /// @param color    Unlit color to modulate
+    ///
+    /// @return The lit color
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Color shade(sf::Uint32 index, const sf::Color& color) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A tile reached by a light and the light's falloff there
+    ///////////////////////////////////////////////////////////////////////////
+    struct Lit {
+        sf::Uint32 index;
+        sf::Uint8 level;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A light along with the state needed to update it incrementally
+    ///////////////////////////////////////////////////////////////////////////
+    struct Source {
+        Light light;
+        bool active = false;
+        bool pending = false;
+        bool repropagate = false;
+        sf::Color appliedColor;
+        sf::Uint8 appliedIntensity = 0;
+        std::vector<Lit> footprint;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of lights flood filled per job
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 PropagateGrain = 4;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Working memory of a flood fill, one per thread
+    ///
+    /// A new stamp marks a new fill, which avoids clearing visited before
+    /// every fill.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Scratch {
+        std::vector<sf::Uint32> visited;
+        std::vector<sf::Uint32> queue;
+        sf::Uint32 stamp = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Per-channel sum of all light contributions at a tile
+    ///////////////////////////////////////////////////////////////////////////
+    struct Level {
+        sf::Int32 r = 0;
+        sf::Int32 g = 0;
+        sf::Int32 b = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Exits if a handle isn't of a light which exists
+    ///
+    /// @param id   Handle of the light
+    ///////////////////////////////////////////////////////////////////////////
+    void checkLight(LightId id) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Queues a light to be updated on the next update()
+    ///
+    /// @param id           Handle of the light
+    /// @param repropagate  True if the footprint must be recomputed
+    ///////////////////////////////////////////////////////////////////////////
+    void markPending(LightId id, bool repropagate);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds (sign = 1) or removes (sign = -1) a light's contribution
+    ///
+    /// @param source   The light
+    /// @param sign     Whether to add or subtract the contribution
+    ///////////////////////////////////////////////////////////////////////////
+    void accumulate(const Source& source, sf::Int32 sign);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Recomputes the footprint of a light by flood filling outwards
+    ///        from its position through transparent tiles
+    ///
+    /// This only writes to the light and the scratch, so lights can be
+    /// propagated at the same time with different scratches.
+    ///
+    /// @param source   The light
+    /// @param scratch  Working memory of the calling thread
+    ///////////////////////////////////////////////////////////////////////////
+    void propagate(Source& source, Scratch& scratch) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a tile to the dirty tiles if it is not already there
+    ///
+    /// @param index    Index of the tile
+    ///////////////////////////////////////////////////////////////////////////
+    void markDirty(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Vector2u m_area;
+    sf::Color m_ambient = sf::Color(Neutral, Neutral, Neutral);
+    std::vector<Level> m_levels;
+    std::vector<Source> m_sources;
+    std::vector<LightId> m_pending;
+    std::vector<LightId> m_freeIds;
+    std::vector<sf::Uint8> m_opaque;
+    std::vector<sf::Uint8> m_dirtyFlags;
+    std::vector<sf::Uint32> m_dirtyTiles;
+    std::vector<LightId> m_propagating;
+    std::vector<Scratch> m_scratches;
+};
+
+#endif
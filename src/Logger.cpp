@@ -0,0 +1,290 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Logger.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Leveled logging, written out by a background thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Logger.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include "AllocationTracker.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Serializes writing to the streams, and whether the logger has been
+/// destroyed. Both are constant initialized, so outlive the logger.
+///////////////////////////////////////////////////////////////////////////////
+static std::mutex writeMutex;
+static std::atomic<bool> destroyed{false};
+
+///////////////////////////////////////////////////////////////////////////////
+/// The index of each thread's ring
+///////////////////////////////////////////////////////////////////////////////
+static thread_local sf::Uint32 ringIndex = Logger::MaxThreads + 1;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Writes a message with its prefix, without flushing
+///////////////////////////////////////////////////////////////////////////////
+static void writeMessage(Logger::Level level, const char* file,
+                         const char* function, int line, const char* message,
+                         std::size_t length)
+{
+    static const char* labels[] = {"DEBUG", "INFO", "WARN", "EXIT"};
+
+    auto& stream = level < Logger::Warn ? std::clog : std::cerr;
+    stream << '[' << labels[level] << "][" << file << "][" << function
+           << "][" << line << "]: ";
+    stream.write(message, static_cast<std::streamsize>(length));
+    stream << '\n';
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Logger::Logger()
+    : m_epoch(std::chrono::steady_clock::now())
+{
+    AllocationTracker::Untracked untracked;
+    m_pending.reserve(RingSize);
+    m_thread = std::thread(&Logger::run, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Logger::~Logger()
+{
+    destroyed.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping.store(true);
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::lock_guard<std::mutex> lock(writeMutex);
+    drain();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::write(Level level, const char* file, const char* function,
+                   int line, const char* message)
+{
+    auto length = std::strlen(message);
+
+    if (destroyed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        writeMessage(level, file, function, line, message, length);
+        std::clog.flush();
+        return;
+    }
+
+    get().enqueue(level, file, function, line, message, length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::write(Level level, const char* file, const char* function,
+                   int line, const std::string& message)
+{
+    if (destroyed.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        writeMessage(level, file, function, line, message.c_str(),
+                     message.size());
+        std::clog.flush();
+        return;
+    }
+
+    get().enqueue(level, file, function, line, message.c_str(),
+                  message.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::exit(const char* file, const char* function, int line,
+                  const std::string& message)
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (!destroyed.load(std::memory_order_acquire)) {
+            get().drain();
+        }
+
+        writeMessage(Exit, file, function, line, message.c_str(),
+                     message.size());
+        std::clog.flush();
+        std::cerr.flush();
+    }
+
+    std::exit(-1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::flush()
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!destroyed.load(std::memory_order_acquire)) {
+        get().drain();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Logger& Logger::get()
+{
+    static Logger logger;
+    return logger;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::enqueue(Level level, const char* file, const char* function,
+                     int line, const char* message, std::size_t length)
+{
+    if (ringIndex > MaxThreads) {
+        ringIndex = addRing();
+    }
+
+    // Without a ring the message is written in order after those queued
+    if (ringIndex == MaxThreads) {
+        writeSynchronously(level, file, function, line, message, length);
+        return;
+    }
+
+    auto& ring = *m_rings[ringIndex];
+    auto head = ring.head.load(std::memory_order_relaxed);
+
+    // Once the logger is stopping nothing may drain the ring any more
+    while (head - ring.tail.load(std::memory_order_acquire) >= RingSize) {
+        if (m_stopping.load()) {
+            writeSynchronously(level, file, function, line, message, length);
+            return;
+        }
+        m_condition.notify_one();
+        std::this_thread::yield();
+    }
+
+    auto& record = ring.records[head % RingSize];
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_epoch).count();
+    record.file = file;
+    record.function = function;
+    record.line = line;
+    record.level = level;
+
+    if (length > MessageSize) {
+        std::memcpy(record.message, message, MessageSize - 3);
+        std::memcpy(record.message + MessageSize - 3, "...", 3);
+        length = MessageSize;
+    }
+    else {
+        std::memcpy(record.message, message, length);
+    }
+    record.length = static_cast<sf::Uint32>(length);
+
+    ring.head.store(head + 1, std::memory_order_release);
+
+    // The destructor may have drained the rings for the last time since the
+    // caller checked it was alive, in which case the message is written out
+    // here. The fences pair with the destructor's, so that either it drains
+    // the message or this sees it stopping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_stopping.load()) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        drain();
+        return;
+    }
+
+    // This doesn't take the lock, so the logger's thread may miss the
+    // wakeup, but then it still wakes up within FlushIntervalMs
+    if (level >= Warn ||
+        head + 1 - ring.tail.load(std::memory_order_relaxed) >= RingSize / 2) {
+        m_condition.notify_one();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::writeSynchronously(Level level, const char* file,
+                                const char* function, int line,
+                                const char* message, std::size_t length)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    drain();
+    writeMessage(level, file, function, line, message, length);
+    std::clog.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Logger::addRing()
+{
+    AllocationTracker::Untracked untracked;
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+    auto index = m_ringCount.load(std::memory_order_relaxed);
+    if (index == MaxThreads) {
+        return MaxThreads;
+    }
+
+    m_rings[index] = std::make_unique<Ring>();
+    m_ringCount.store(index + 1, std::memory_order_release);
+
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::drain()
+{
+    m_pending.clear();
+
+    auto count = m_ringCount.load(std::memory_order_acquire);
+    for (sf::Uint32 i = 0; i < count; ++i) {
+        auto& ring = *m_rings[i];
+        auto head = ring.head.load(std::memory_order_acquire);
+        auto tail = ring.tail.load(std::memory_order_relaxed);
+
+        for (; tail != head; ++tail) {
+            m_pending.push_back(ring.records[tail % RingSize]);
+        }
+
+        // The messages have been copied, so the thread may overwrite them
+        ring.tail.store(head, std::memory_order_release);
+    }
+
+    if (m_pending.empty()) {
+        return;
+    }
+
+    // Each thread's messages are in order, the threads' are not
+    std::stable_sort(m_pending.begin(), m_pending.end(),
+                     [](const Record& a, const Record& b) {
+                         return a.time < b.time;
+                     });
+
+    for (const auto& record : m_pending) {
+        writeMessage(record.level, record.file, record.function, record.line,
+                     record.message, record.length);
+    }
+
+    std::clog.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Logger::run()
+{
+    AllocationTracker::Untracked untracked;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        m_condition.wait_for(lock,
+                             std::chrono::milliseconds(FlushIntervalMs));
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> write(writeMutex);
+            drain();
+        }
+
+        lock.lock();
+    }
+}
@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Logger.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Leveled logging, written out by a background thread
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__LOGGER_HPP
+#define ROGUELIKE__LOGGER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Leveled logging, written out by a background thread
+///
+/// Messages are copied, with the file, function and line they were logged
+/// at, into a ring owned by the thread logging them. Only that thread writes
+/// to its ring and only the logger's thread reads it, so logging takes no
+/// lock and does no I/O, and the prefix of each message is only formatted
+/// once it is written out. Only the first message on each thread locks, to
+/// add the thread's ring, and threads wait for their ring to be written out
+/// when it is full rather than drop messages. Messages logged while the
+/// logger is being destroyed are written synchronously instead.
+///
+/// The logger's thread writes out the rings every FlushIntervalMs, and as
+/// soon as a warning is logged. Messages are written in the order they were
+/// logged in, to std::clog below Warn and std::cerr otherwise.
+///
+/// Exit messages are written synchronously, after every message before
+/// them, and then the program exits.
+///
+/// Messages are logged through the log_* macros in Common.hpp, which leave
+/// out the levels below ROGUELIKE_LOG_LEVEL at compile time.
+///////////////////////////////////////////////////////////////////////////////
+class Logger {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Severity of a message
+    ///////////////////////////////////////////////////////////////////////////
+    enum Level {
+        Debug,
+        Info,
+        Warn,
+        Exit
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of messages each thread's ring holds
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 RingSize = 1 << 10;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Most threads which can have rings
+    ///
+    /// Messages logged on any further threads are written synchronously.
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MaxThreads = 64;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Most characters of a message kept in a ring
+    ///
+    /// Longer messages are cut short, and end in "...".
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MessageSize = 224;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Longest time a message waits to be written out
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Int32 FlushIntervalMs = 50;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    Logger(const Logger&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const Logger&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes out the messages still queued and stops the thread
+    ///
+    /// Messages logged afterwards, while the program exits, are written
+    /// synchronously.
+    ///////////////////////////////////////////////////////////////////////////
+    ~Logger();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Logs a message
+    ///
+    /// @param level    Level of the message, below Exit
+    /// @param file     File the message was logged in
+    /// @param function Function the message was logged in
+    /// @param line     Line the message was logged at
+    /// @param message  Message to log
+    ///////////////////////////////////////////////////////////////////////////
+    static void write(Level level, const char* file, const char* function,
+                      int line, const char* message);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Logs a message
+    ///
+    /// @param level    Level of the message, below Exit
+    /// @param file     File the message was logged in
+    /// @param function Function the message was logged in
+    /// @param line     Line the message was logged at
+    /// @param message  Message to log
+    ///////////////////////////////////////////////////////////////////////////
+    static void write(Level level, const char* file, const char* function,
+                      int line, const std::string& message);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes out every queued message and an exit message, then
+    ///        calls std::exit(-1)
+    ///
+    /// @param file     File the message was logged in
+    /// @param function Function the message was logged in
+    /// @param line     Line the message was logged at
+    /// @param message  Message to log
+    ///////////////////////////////////////////////////////////////////////////
+    [[noreturn]] static void exit(const char* file, const char* function,
+                                  int line, const std::string& message);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes out every queued message before returning
+    ///////////////////////////////////////////////////////////////////////////
+    static void flush();
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A logged message
+    ///
+    /// file and function are string literals, so outlive the message.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Record {
+        sf::Int64 time;
+        const char* file;
+        const char* function;
+        int line;
+        Level level;
+        sf::Uint32 length;
+        char message[MessageSize];
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Ring of the messages logged on a thread
+    ///
+    /// head is only written by the owning thread and tail by drain(), so the
+    /// messages between them can be read without a lock.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Ring {
+        std::vector<Record> records = std::vector<Record>(RingSize);
+        std::atomic<sf::Uint64> head{0};
+        std::atomic<sf::Uint64> tail{0};
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor, which starts the logger's thread
+    ///////////////////////////////////////////////////////////////////////////
+    Logger();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the logger, creating it on first use
+    ///
+    /// @return The logger
+    ///////////////////////////////////////////////////////////////////////////
+    static Logger& get();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Queues a message in the calling thread's ring
+    ///
+    /// @param level    Level of the message
+    /// @param file     File the message was logged in
+    /// @param function Function the message was logged in
+    /// @param line     Line the message was logged at
+    /// @param message  Message to log
+    /// @param length   Length of the message
+    ///////////////////////////////////////////////////////////////////////////
+    void enqueue(Level level, const char* file, const char* function,
+                 int line, const char* message, std::size_t length);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes a message right away, after the queued messages
+    ///
+    /// @param level    Level of the message
+    /// @param file     File the message was logged in
+    /// @param function Function the message was logged in
+    /// @param line     Line the message was logged at
+    /// @param message  Message to log
+    /// @param length   Length of the message
+    ///////////////////////////////////////////////////////////////////////////
+    void writeSynchronously(Level level, const char* file,
+                            const char* function, int line,
+                            const char* message, std::size_t length);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a ring for the calling thread
+    ///
+    /// @return Index of the ring, or MaxThreads if there are too many threads
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 addRing();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes out the queued messages
+    ///
+    /// The write mutex must be held.
+    ///////////////////////////////////////////////////////////////////////////
+    void drain();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes out the rings until the logger is destroyed
+    ///////////////////////////////////////////////////////////////////////////
+    void run();
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::chrono::steady_clock::time_point m_epoch;
+    std::mutex m_ringsMutex;
+    std::array<std::unique_ptr<Ring>, MaxThreads> m_rings;
+    std::atomic<sf::Uint32> m_ringCount{0};
+    std::vector<Record> m_pending;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
+
+#endif
@@ -9,31 +9,146 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ctime>
+#include <string>
 #include <cstdlib>
 #include "Game.hpp"
+#include "Common.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Main
+///
+/// Options:
+///     --seed <n>      Seed the game with n rather than the current time
+///     --record <path> Record the session's input to a file on exit
+///     --replay <path> Play back a recorded session as fast as possible
+///     --script <path> Play back an input script as fast as possible
+///     --stats <path>  Write frame time percentiles as CSV on exit
+///     --headless      Run without a window, for a replay or script
+///     --offscreen     Compose a frame per step of a replay or script
+///     --baseline <path>
+///                     Fail if a replay's statistics regressed from those
+///                     in path, which needs --stats
+///     --tolerance <percent>
+///                     How much slower than the baseline times may get
+///     --tolerance-ms <ms>
+///                     How much slower times may always get
+///     --check-allocations <n>
+///                     Exit if any frame after the first n allocates
 ///////////////////////////////////////////////////////////////////////////////
-int main()
+int main(int argc, char** argv)
 {
-    srand(static_cast<uint32_t>(time(nullptr)));
-    auto windowMode = sf::VideoMode::getFullscreenModes()[0];
     Game::Settings gameSettings = {
         {
             false,
             sf::Style::Fullscreen,
             "SFML App",
-            windowMode,
+            sf::VideoMode(),
             0
         },
         {
             {896, 504}
+        },
+        {
+            16,
+            5
+        },
+        {
+            static_cast<sf::Uint32>(time(nullptr)),
+            "",
+            "",
+            "",
+            "",
+            false,
+            false
+        },
+        {
+            "",
+            {10.f, 0.05f}
+        },
+        {
+            10,
+            100
+        },
+        {
+            false,
+            0
         }
     };
 
-    Game game(gameSettings);
-    game.play();
+    for (int i = 1; i < argc; ++i) {
+        std::string option(argv[i]);
+
+        if (option == "--headless") {
+            gameSettings.session.headless = true;
+            continue;
+        }
+        else if (option == "--offscreen") {
+            gameSettings.session.offscreen = true;
+            continue;
+        }
 
-    return 0;
+        if (++i >= argc) {
+            log_exit("Missing value for option: " + option);
+        }
+
+        std::string value(argv[i]);
+
+        if (option == "--seed") {
+            char* end = nullptr;
+            auto seed = std::strtoul(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || seed > 0xFFFFFFFFul) {
+                log_exit("Invalid seed: " + value);
+            }
+            gameSettings.session.seed = static_cast<sf::Uint32>(seed);
+        }
+        else if (option == "--record") {
+            gameSettings.session.recordPath = value;
+        }
+        else if (option == "--replay") {
+            gameSettings.session.replayPath = value;
+        }
+        else if (option == "--script") {
+            gameSettings.session.scriptPath = value;
+        }
+        else if (option == "--stats") {
+            gameSettings.session.statsPath = value;
+        }
+        else if (option == "--baseline") {
+            gameSettings.baseline.path = value;
+        }
+        else if (option == "--tolerance" || option == "--tolerance-ms") {
+            char* end = nullptr;
+            auto tolerance = std::strtof(value.c_str(), &end);
+            if (value.empty() || *end != '\0' || !(tolerance >= 0.f)) {
+                log_exit("Invalid tolerance: " + value);
+            }
+
+            auto& setting = option == "--tolerance"
+                ? gameSettings.baseline.tolerance.percent
+                : gameSettings.baseline.tolerance.minimumMs;
+            setting = tolerance;
+        }
+        else if (option == "--check-allocations") {
+            char* end = nullptr;
+            auto frames = std::strtoul(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || frames > 0xFFFFFFFFul) {
+                log_exit("Invalid warm-up frame count: " + value);
+            }
+            gameSettings.allocations.check = true;
+            gameSettings.allocations.warmupFrames =
+                static_cast<sf::Uint32>(frames);
+        }
+        else {
+            log_exit("Unknown option: " + option);
+        }
+    }
+
+    // Even listing the video modes needs a display
+    if (!gameSettings.session.headless) {
+        gameSettings.window.mode = sf::VideoMode::getFullscreenModes()[0];
+    }
+
+    // Replays which regressed from their baseline fail
+    Game game(gameSettings);
+    return game.play() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
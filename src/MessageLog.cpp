@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   MessageLog.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Fixed-capacity history of game messages, stored as wrapped lines
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MessageLog.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+MessageLog::MessageLog(sf::Uint32 width,
+                       sf::Uint32 lineCapacity,
+                       sf::Uint32 charCapacity)
+    : m_width(width), m_lines(lineCapacity), m_chars(charCapacity)
+{
+    if (!width || !lineCapacity || charCapacity < width) {
+        log_exit("Invalid message log capacity");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLog::push(const sf::String& message, const sf::Color& color)
+{
+    std::size_t size = message.getSize();
+    std::size_t begin = 0;
+
+    if (!size) {
+        pushLine(message, 0, 0, color);
+        return;
+    }
+
+    while (begin < size) {
+        auto end = std::min(begin + m_width, size);
+
+        // Break at the last space that fits, unless the word is too long
+        if (end < size) {
+            auto space = end;
+            while (space > begin && message[space] != ' ') {
+                --space;
+            }
+            if (space > begin) {
+                end = space;
+            }
+        }
+
+        pushLine(message, begin, end, color);
+
+        // Wrapped lines don't start with the space they were broken at
+        begin = end;
+        while (begin < size && message[begin] == ' ') {
+            ++begin;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 MessageLog::getWidth() const
+{
+    return m_width;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 MessageLog::getLineCount() const
+{
+    return m_lineCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 MessageLog::getTotalLines() const
+{
+    return m_totalLines;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const MessageLog::Line& MessageLog::getLine(sf::Uint32 index) const
+{
+    if (index >= m_lineCount) {
+        log_exit("Line index out of range: " + std::to_string(index));
+    }
+
+    return m_lines[(m_firstLine + index) % m_lines.size()];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const sf::Uint32* MessageLog::getCharacters(const Line& line) const
+{
+    return m_chars.data() + line.offset;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLog::pushLine(const sf::String& message, std::size_t begin,
+                          std::size_t end, const sf::Color& color)
+{
+    // Empty lines still take up one character, so that every line occupies
+    // part of the arena and the oldest line is always the next one overwritten
+    auto length = std::max(static_cast<sf::Uint32>(end - begin), 1u);
+    auto capacity = static_cast<sf::Uint32>(m_chars.size());
+
+    // Lines are allocated one after another in both rings, so the oldest
+    // line is always the first one after the head of each ring
+    auto evict = [this](sf::Uint32 from, sf::Uint32 to) {
+        while (m_lineCount) {
+            const auto& oldest = m_lines[m_firstLine];
+            if (oldest.offset >= to || oldest.offset + oldest.length <= from) {
+                break;
+            }
+            dropLine();
+        }
+    };
+
+    if (m_lineCount == m_lines.size()) {
+        dropLine();
+    }
+
+    // Lines never wrap around the end of the arena
+    if (m_charHead + length > capacity) {
+        evict(m_charHead, capacity);
+        m_charHead = 0;
+    }
+    evict(m_charHead, m_charHead + length);
+
+    for (sf::Uint32 i = 0; i < length; ++i) {
+        m_chars[m_charHead + i] = begin + i < end ? message[begin + i] : ' ';
+    }
+
+    auto index = (m_firstLine + m_lineCount) % m_lines.size();
+    m_lines[index] = {m_charHead, length, color};
+    m_charHead += length;
+    ++m_lineCount;
+    ++m_totalLines;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLog::dropLine()
+{
+    m_firstLine = static_cast<sf::Uint32>((m_firstLine + 1) % m_lines.size());
+    --m_lineCount;
+}
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   MessageLog.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Fixed-capacity history of game messages, stored as wrapped lines
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__MESSAGE_LOG_HPP
+#define ROGUELIKE__MESSAGE_LOG_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Fixed-capacity history of game messages, stored as wrapped lines
+///
+/// Messages are word wrapped to the width of the log when they are pushed,
+/// and each wrapped line is kept as a run of characters ready to be copied
+/// straight into a row of tiles. The characters of all lines live in a
+/// single preallocated ring (the arena) and the lines themselves in a second
+/// ring, so pushing a message never allocates, and the oldest lines are
+/// dropped when either ring is full. Looking up any line is O(1), so showing
+/// a slice of the log costs the same however many messages it holds.
+///////////////////////////////////////////////////////////////////////////////
+class MessageLog {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A wrapped line of a message
+    ///////////////////////////////////////////////////////////////////////////
+    struct Line {
+        sf::Uint32 offset;
+        sf::Uint32 length;
+        sf::Color color;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///
+    /// @param width            Number of characters to wrap lines at
+    /// @param lineCapacity     Maximum number of lines kept
+    /// @param charCapacity     Size of the character arena shared by the lines
+    ///////////////////////////////////////////////////////////////////////////
+    MessageLog(sf::Uint32 width,
+               sf::Uint32 lineCapacity = 1 << 17,
+               sf::Uint32 charCapacity = 1 << 21);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    MessageLog(const MessageLog&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const MessageLog&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a message, wrapping it to the width of the log
+    ///
+    /// @param message  Text of the message
+    /// @param color    Color of the message's characters
+    ///////////////////////////////////////////////////////////////////////////
+    void push(const sf::String& message,
+              const sf::Color& color = sf::Color::White);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of characters lines are wrapped at
+    ///
+    /// @return Width of the log
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getWidth() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of lines currently kept
+    ///
+    /// @return Number of lines
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getLineCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of lines ever pushed, including dropped ones
+    ///
+    /// This changes whenever a message is pushed, so it also serves as the
+    /// version of the log.
+    ///
+    /// @return Number of lines pushed
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint64 getTotalLines() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a kept line
+    ///
+    /// @param index    Index of the line, 0 being the oldest kept line
+    ///
+    /// @return The line
+    ///////////////////////////////////////////////////////////////////////////
+    const Line& getLine(sf::Uint32 index) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the characters of a line
+    ///
+    /// @param line A line returned by getLine()
+    ///
+    /// @return Pointer to line.length characters
+    ///////////////////////////////////////////////////////////////////////////
+    const sf::Uint32* getCharacters(const Line& line) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Copies a wrapped line of a message into the rings
+    ///
+    /// @param message  Text of the message
+    /// @param begin    Index of the line's first character in the message
+    /// @param end      Index one past the line's last character
+    /// @param color    Color of the line
+    ///////////////////////////////////////////////////////////////////////////
+    void pushLine(const sf::String& message, std::size_t begin,
+                  std::size_t end, const sf::Color& color);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Drops the oldest line
+    ///////////////////////////////////////////////////////////////////////////
+    void dropLine();
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 m_width;
+    std::vector<Line> m_lines;
+    std::vector<sf::Uint32> m_chars;
+    sf::Uint32 m_firstLine = 0;
+    sf::Uint32 m_lineCount = 0;
+    sf::Uint32 m_charHead = 0;
+    sf::Uint64 m_totalLines = 0;
+};
+
+#endif
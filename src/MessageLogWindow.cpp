@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   MessageLogWindow.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Window showing the most recent lines of a MessageLog
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MessageLogWindow.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+MessageLogWindow::MessageLogWindow(const std::string& tag,
+                                   const MessageLog& log,
+                                   sf::Uint32 rows)
+    : Window(tag),
+      m_log(log),
+      m_glyphMap(State::get().font, {log.getWidth(), rows}, {8, 18}, 16)
+{
+    GlyphTileMap::Tile blank(' ', GlyphTileMap::Tile::Text,
+                             sf::Color::White, sf::Color(20, 20, 20));
+
+    for (sf::Uint32 x = 0; x < m_glyphMap.getArea().x; ++x) {
+        for (sf::Uint32 y = 0; y < m_glyphMap.getArea().y; ++y) {
+            m_glyphMap.setTile({x, y}, blank);
+        }
+    }
+
+    setPosition(0.f, static_cast<float>(
+        State::get().frameSize.y - (rows * m_glyphMap.getSpacing().y)));
+
+    m_shownTotal = m_log.getTotalLines();
+    showLines();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLogWindow::update()
+{
+    auto total = m_log.getTotalLines();
+    auto scroll = static_cast<sf::Int64>(m_scroll);
+
+    // Keep the lines being read in place while scrolled back
+    if (scroll) {
+        scroll += static_cast<sf::Int64>(total - m_shownTotal);
+    }
+
+    if (consumeMouse && State::get().scrollDelta != 0.f) {
+        scroll += static_cast<sf::Int64>(State::get().scrollDelta *
+                                         ScrollSpeed);
+    }
+
+    auto count = static_cast<sf::Int64>(m_log.getLineCount());
+    auto rows = static_cast<sf::Int64>(m_glyphMap.getArea().y);
+    scroll = std::min(std::max(scroll, sf::Int64(0)),
+                      std::max(count - rows, sf::Int64(0)));
+
+    if (total != m_shownTotal || scroll != m_scroll) {
+        m_shownTotal = total;
+        m_scroll = static_cast<sf::Uint32>(scroll);
+        showLines();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::FloatRect MessageLogWindow::getBounds() const
+{
+    auto area = m_glyphMap.getArea();
+    auto spacing = m_glyphMap.getSpacing();
+
+    return getTransform().transformRect(sf::FloatRect(
+        0.f, 0.f,
+        static_cast<float>(area.x * spacing.x),
+        static_cast<float>(area.y * spacing.y)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 MessageLogWindow::getContentVersion() const
+{
+    return m_glyphMap.getVersion();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool MessageLogWindow::appendVertices(RenderBatch& batch) const
+{
+    m_glyphMap.appendVertices(batch.getVertices(&m_glyphMap.getTexture()),
+                              getTransform());
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool MessageLogWindow::containsMouse() const
+{
+    return containsPosition(State::get().mousePosition);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool MessageLogWindow::containsPosition(const sf::Vector2i& position) const
+{
+    return getBounds().contains(sf::Vector2f(position));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLogWindow::draw(sf::RenderTarget& target,
+                            sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    target.draw(m_glyphMap, states);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MessageLogWindow::showLines()
+{
+    auto area = m_glyphMap.getArea();
+
+    // The line in the top row, negative while the log has fewer lines than
+    // the window has rows
+    auto first = static_cast<sf::Int64>(m_log.getLineCount()) -
+                 static_cast<sf::Int64>(area.y) -
+                 static_cast<sf::Int64>(m_scroll);
+
+    for (sf::Uint32 y = 0; y < area.y; ++y) {
+        const sf::Uint32* characters = nullptr;
+        sf::Uint32 length = 0;
+        sf::Color color = sf::Color::White;
+
+        auto index = first + y;
+        if (index >= 0) {
+            const auto& line = m_log.getLine(static_cast<sf::Uint32>(index));
+            characters = m_log.getCharacters(line);
+            length = line.length;
+            color = line.color;
+        }
+
+        // Only touch the tiles which actually change
+        for (sf::Uint32 x = 0; x < area.x; ++x) {
+            auto character = x < length ? characters[x] : ' ';
+            const auto& tile = m_glyphMap.getTile({x, y});
+
+            if (tile.character != character) {
+                m_glyphMap.setTileCharacter({x, y}, character,
+                                            GlyphTileMap::Tile::Text);
+            }
+            if (tile.foreground != color) {
+                m_glyphMap.setTileFgColor({x, y}, color);
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   MessageLogWindow.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Window showing the most recent lines of a MessageLog
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__MESSAGE_LOG_WINDOW_HPP
+#define ROGUELIKE__MESSAGE_LOG_WINDOW_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Window.hpp"
+#include "MessageLog.hpp"
+#include "GlyphTileMap.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Window showing the most recent lines of a MessageLog
+///
+/// The window has one row of tiles per visible line, and only rewrites those
+/// rows when a message is pushed or the window is scrolled, so its cost per
+/// frame doesn't depend on the number of messages in the log. Scrolling the
+/// mouse wheel over the window scrolls back through the log, and while
+/// scrolled back new messages don't move the lines being read.
+///////////////////////////////////////////////////////////////////////////////
+class MessageLogWindow : public Window {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of lines scrolled per mouse wheel step
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr float ScrollSpeed = 3.f;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///
+    /// The window is as wide as the log, and is placed at the bottom-left
+    /// corner of the frame.
+    ///
+    /// @param tag  Tag of the window
+    /// @param log  Log to show, which must outlive the window
+    /// @param rows Number of visible lines
+    ///////////////////////////////////////////////////////////////////////////
+    MessageLogWindow(const std::string& tag, const MessageLog& log,
+                     sf::Uint32 rows);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    MessageLogWindow() = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    MessageLogWindow(const MessageLogWindow&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const MessageLogWindow&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Scrolls the window and shows any new messages
+    ///////////////////////////////////////////////////////////////////////////
+    void update() override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::FloatRect getBounds() const override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint64 getContentVersion() const override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool appendVertices(RenderBatch& batch) const override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool containsMouse() const override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool containsPosition(const sf::Vector2i& position) const override;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Overloaded draw function from sf::Drawable/sf::Transformable
+    ///////////////////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target,
+              sf::RenderStates states) const override;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Copies the visible lines of the log into the tiles
+    ///////////////////////////////////////////////////////////////////////////
+    void showLines();
+
+    ///////////////////////////////////////////////////////////////////////////
+    const MessageLog& m_log;
+    GlyphTileMap m_glyphMap;
+    sf::Uint64 m_shownTotal = 0;
+    sf::Uint32 m_scroll = 0;
+};
+
+#endif
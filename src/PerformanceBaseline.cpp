@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   PerformanceBaseline.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Frame and zone times of a run, compared against a baseline run
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PerformanceBaseline.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Splits a line of CSV into its fields, which never hold commas
+///////////////////////////////////////////////////////////////////////////////
+static std::vector<std::string> splitFields(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.push_back(field);
+    }
+
+    // getline() doesn't return the empty field after a trailing comma
+    if (!line.empty() && line.back() == ',') {
+        fields.emplace_back();
+    }
+
+    return fields;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool PerformanceBaseline::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        log_warn("Could not open statistics: " + path);
+        return false;
+    }
+
+    static const char* columnNames[] = {
+        "zone", "parent", "depth", "mean_ms", "p50_ms", "p95_ms", "p99_ms",
+        "max_ms"
+    };
+    static constexpr std::size_t ColumnCount =
+        sizeof(columnNames) / sizeof(columnNames[0]);
+
+    std::string line;
+    std::getline(file, line);
+    auto header = splitFields(line);
+
+    std::size_t columns[ColumnCount];
+    for (std::size_t i = 0; i < ColumnCount; ++i) {
+        auto it = std::find(header.begin(), header.end(), columnNames[i]);
+        if (it == header.end()) {
+            log_warn("Statistics have no " + std::string(columnNames[i]) +
+                     " column: " + path);
+            return false;
+        }
+        columns[i] = static_cast<std::size_t>(it - header.begin());
+    }
+
+    m_metrics.clear();
+
+    for (sf::Uint32 number = 2; std::getline(file, line); ++number) {
+        if (line.empty()) {
+            continue;
+        }
+
+        auto fields = splitFields(line);
+        if (fields.size() != header.size()) {
+            log_warn("Invalid statistics at line " + std::to_string(number) +
+                     ": " + path);
+            return false;
+        }
+
+        // Times are checked, as strtof() quietly reads garbage as 0
+        float times[ColumnCount - 3];
+        for (std::size_t i = 3; i < ColumnCount; ++i) {
+            const auto& field = fields[columns[i]];
+            char* end = nullptr;
+            times[i - 3] = std::strtof(field.c_str(), &end);
+
+            if (field.empty() || *end != '\0') {
+                log_warn("Invalid time at line " + std::to_string(number) +
+                         ": " + path);
+                return false;
+            }
+        }
+
+        m_metrics.push_back({fields[columns[0]], fields[columns[1]],
+                             fields[columns[2]], times[0], times[1],
+                             times[2], times[3], times[4]});
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<PerformanceBaseline::Metric>&
+PerformanceBaseline::getMetrics() const
+{
+    return m_metrics;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 PerformanceBaseline::compare(const PerformanceBaseline& baseline,
+                                        const Tolerance& tolerance) const
+{
+    sf::Uint32 regressions = 0;
+
+    auto check = [&](const Metric& metric, const char* statistic,
+                     float time, float baselineTime) {
+        auto allowed = std::max(baselineTime * tolerance.percent / 100.f,
+                                tolerance.minimumMs);
+        if (time - baselineTime <= allowed) {
+            return;
+        }
+
+        char change[64];
+        std::snprintf(change, sizeof(change),
+                      " %s %.3f ms, baseline %.3f ms", statistic, time,
+                      baselineTime);
+
+        auto name = metric.parent.empty()
+            ? metric.zone : metric.parent + " > " + metric.zone;
+        log_warn("Regression in " + name + change);
+        ++regressions;
+    };
+
+    for (const auto& metric : m_metrics) {
+        auto expected = baseline.find(metric);
+        if (!expected) {
+            continue;
+        }
+
+        check(metric, "mean", metric.mean, expected->mean);
+        check(metric, "p50", metric.p50, expected->p50);
+        check(metric, "p95", metric.p95, expected->p95);
+    }
+
+    return regressions;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const PerformanceBaseline::Metric*
+PerformanceBaseline::find(const Metric& metric) const
+{
+    for (const auto& candidate : m_metrics) {
+        if (candidate.zone == metric.zone &&
+            candidate.parent == metric.parent &&
+            candidate.depth == metric.depth) {
+            return &candidate;
+        }
+    }
+
+    return nullptr;
+}
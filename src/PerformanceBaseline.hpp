@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   PerformanceBaseline.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Frame and zone times of a run, compared against a baseline run
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__PERFORMANCE_BASELINE_HPP
+#define ROGUELIKE__PERFORMANCE_BASELINE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Frame and zone times of a run, compared against a baseline run
+///
+/// Runs are loaded from the CSV written by Profiler::writeStatistics(), so
+/// the statistics of any run can be kept as the baseline of later runs.
+/// Runs are only comparable when they replay the same session on the same
+/// machine in the same mode.
+///
+/// The mean, p50 and p95 of the frames and of every zone are compared. The
+/// p99 and maximum of a replay are too often a single hitch to compare.
+///////////////////////////////////////////////////////////////////////////////
+class PerformanceBaseline {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief How much slower a time may get before it has regressed
+    ///
+    /// A time regresses when it exceeds the baseline's by more than percent
+    /// of it and by more than minimumMs, which keeps the noise of the
+    /// quickest zones from failing runs.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Tolerance {
+        float percent;
+        float minimumMs;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Times of the frames or of a distinct zone, in ms per frame
+    ///
+    /// The frames have the zone "Frame" and empty parent and depth.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Metric {
+        std::string zone;
+        std::string parent;
+        std::string depth;
+        float mean;
+        float p50;
+        float p95;
+        float p99;
+        float maximum;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    PerformanceBaseline() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Loads the statistics of a run
+    ///
+    /// Columns are found by their names in the header, so files with more
+    /// columns than are compared still load.
+    ///
+    /// @param path Path of the statistics CSV
+    ///
+    /// @return True if the file was loaded, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& path);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the times of the run
+    ///
+    /// @return Times of the frames, then of each zone
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<Metric>& getMetrics() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Compares the run with a baseline, logging every regression
+    ///
+    /// Zones which aren't in both runs can't be compared, and are skipped.
+    ///
+    /// @param baseline     The baseline run
+    /// @param tolerance    How much slower times may get
+    ///
+    /// @return Number of times which regressed
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 compare(const PerformanceBaseline& baseline,
+                       const Tolerance& tolerance) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the times of a zone
+    ///
+    /// @param metric   Times of the same zone in another run
+    ///
+    /// @return The times, or null if the zone isn't in this run
+    ///////////////////////////////////////////////////////////////////////////
+    const Metric* find(const Metric& metric) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<Metric> m_metrics;
+};
+
+#endif
@@ -0,0 +1,432 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Profiler.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Hierarchical profiler of scoped zones timed on every thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Profiler.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// The innermost scope on each thread, the index of the thread's ring and the
+/// name the ring is given
+///////////////////////////////////////////////////////////////////////////////
+static thread_local Profiler::Scope* currentScope = nullptr;
+static thread_local sf::Uint32 ringIndex = Profiler::MaxThreads + 1;
+static thread_local const char* threadName = nullptr;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Combines the path of the zone a zone runs in with the zone's name. Names
+/// are string literals, so their addresses tell them apart.
+///////////////////////////////////////////////////////////////////////////////
+static sf::Uint64 combinePath(sf::Uint64 parentPath, const char* name)
+{
+    auto hash = static_cast<sf::Uint64>(
+        reinterpret_cast<std::uintptr_t>(name));
+    return parentPath ^ (hash + 0x9e3779b97f4a7c15ull + (parentPath << 6) +
+                         (parentPath >> 2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler::Scope::Scope(const char* name)
+    : m_name(name),
+      m_parent(currentScope),
+      m_depth(currentScope ? currentScope->m_depth + 1 : 0),
+      m_path(combinePath(currentScope ? currentScope->m_path : 0, name)),
+      m_begin(State::get().profiler.now()),
+      m_allocations(AllocationTracker::getThreadCounts())
+{
+    currentScope = this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler::Scope::~Scope()
+{
+    auto& profiler = State::get().profiler;
+    auto allocations = AllocationTracker::getThreadCounts();
+    currentScope = m_parent;
+
+    profiler.record({m_name, m_parent ? m_parent->m_name : nullptr, m_path,
+                     m_parent ? m_parent->m_path : 0,
+                     m_begin, profiler.now(), m_depth, 0,
+                     {allocations.allocations - m_allocations.allocations,
+                      allocations.bytes - m_allocations.bytes}});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler::Profiler()
+    : m_epoch(std::chrono::steady_clock::now()),
+      m_frameTimes(StatisticsWindows) {}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::setThreadName(const char* name)
+{
+    threadName = name;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::setHistory(sf::Time history)
+{
+    m_historyNs = history.asMicroseconds() * 1000;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Int64 Profiler::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::endFrame(sf::Time frameTime)
+{
+    AllocationTracker::Untracked untracked;
+
+    // This is uncounted, so the frame is everything since the last call
+    auto allocations = AllocationTracker::getTotalCounts();
+    m_frameAllocations = {allocations.allocations -
+                              m_allocationMark.allocations,
+                          allocations.bytes - m_allocationMark.bytes};
+    m_allocationMark = allocations;
+    m_reportAllocations.allocations += m_frameAllocations.allocations;
+    m_reportAllocations.bytes += m_frameAllocations.bytes;
+
+    m_frameZones.clear();
+
+    auto count = m_ringCount.load(std::memory_order_acquire);
+    for (sf::Uint32 i = 0; i < count; ++i) {
+        auto& ring = *m_rings[i];
+        auto head = ring.head.load(std::memory_order_acquire);
+        auto tail = ring.tail.load(std::memory_order_relaxed);
+
+        for (; tail != head; ++tail) {
+            m_frameZones.push_back(ring.zones[tail % RingSize]);
+        }
+
+        // The zones have been copied, so the thread may overwrite them
+        ring.tail.store(head, std::memory_order_release);
+    }
+
+    for (const auto& zone : m_frameZones) {
+        auto& node = getNode(zone);
+        node.frameTime += zone.end - zone.begin;
+        node.allocations.allocations += zone.allocations.allocations;
+        node.allocations.bytes += zone.allocations.bytes;
+        ++node.calls;
+    }
+
+    // Frames a zone didn't run in count as taking no time
+    for (auto& node : m_nodes) {
+        node.totalTime += node.frameTime;
+        node.times.add(sf::microseconds(node.frameTime / 1000));
+        node.frameTime = 0;
+    }
+
+    m_frameTimes.add(frameTime);
+    ++m_frames;
+
+    // Each thread's zones are in order, the threads' are not, so a few
+    // zones may be kept for longer than the history
+    if (m_historyNs) {
+        m_history.insert(m_history.end(), m_frameZones.begin(),
+                         m_frameZones.end());
+
+        auto oldest = now() - m_historyNs;
+        while (!m_history.empty() && m_history.front().end < oldest) {
+            m_history.pop_front();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<Profiler::Zone>& Profiler::getFrameZones() const
+{
+    return m_frameZones;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const AllocationTracker::Counts& Profiler::getFrameAllocations() const
+{
+    return m_frameAllocations;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Profiler::report(std::vector<Line>& lines)
+{
+    AllocationTracker::Untracked untracked;
+    getLines(lines);
+
+    for (auto& node : m_nodes) {
+        node.totalTime = 0;
+        node.calls = 0;
+        node.allocations = {0, 0};
+        node.times.advance();
+    }
+    m_frameTimes.advance();
+    m_reportAllocations = {0, 0};
+
+    auto frames = m_frames;
+    m_frames = 0;
+
+    return frames;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const TimeHistogram& Profiler::getFrameTimes() const
+{
+    return m_frameTimes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Profiler::writeStatistics(const std::string& path) const
+{
+    AllocationTracker::Untracked untracked;
+
+    std::ofstream file(path);
+    file << "zone,parent,depth,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,"
+            "allocations,bytes\n";
+
+    auto frames = static_cast<double>(std::max(m_frames, 1u));
+    auto writeRow = [&file, frames](const char* name, const char* parent,
+                                    const std::string& depth,
+                                    const TimeHistogram& times,
+                                    const AllocationTracker::Counts& counts) {
+        char row[160];
+        std::snprintf(row, sizeof(row),
+                      ",%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f,%.1f\n",
+                      static_cast<unsigned long long>(times.getCount()),
+                      times.getMean().asSeconds() * 1000.f,
+                      times.getPercentile(50.f).asSeconds() * 1000.f,
+                      times.getPercentile(95.f).asSeconds() * 1000.f,
+                      times.getPercentile(99.f).asSeconds() * 1000.f,
+                      times.getMaximum().asSeconds() * 1000.f,
+                      static_cast<double>(counts.allocations) / frames,
+                      static_cast<double>(counts.bytes) / frames);
+        file << name << ',' << (parent ? parent : "") << ',' << depth << row;
+    };
+
+    writeRow("Frame", nullptr, "", m_frameTimes, m_reportAllocations);
+
+    // Rows follow the hierarchy, as in reports, so the names of the zones
+    // a node ran in are those last seen at each depth above it
+    std::vector<std::size_t> order;
+    std::vector<std::string> paths;
+    getOrder(order);
+    for (auto index : order) {
+        const auto& node = m_nodes[index];
+        paths.resize(node.depth + 1);
+        paths[node.depth] = node.depth
+            ? paths[node.depth - 1] + " > " + node.name
+            : node.name;
+
+        writeRow(node.name, node.depth ? paths[node.depth - 1].c_str()
+                                       : nullptr,
+                 std::to_string(node.depth), node.times, node.allocations);
+    }
+
+    if (!file) {
+        log_warn("Could not write profiler statistics: " + path);
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 Profiler::getDroppedCount() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Int64 Profiler::writeTrace(const std::string& path) const
+{
+    AllocationTracker::Untracked untracked;
+
+    std::ofstream file(path);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    char line[256];
+    auto separator = "";
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+        auto count = m_ringCount.load(std::memory_order_relaxed);
+        for (sf::Uint32 i = 0; i < count; ++i) {
+            auto name = "Thread " + std::to_string(i);
+            if (m_threadNames[i]) {
+                name = m_threadNames[i];
+            }
+
+            std::snprintf(line, sizeof(line),
+                          "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                          "\"name\":\"thread_name\","
+                          "\"args\":{\"name\":\"%s\"}}",
+                          i, name.c_str());
+            file << separator << line;
+            separator = ",\n";
+        }
+    }
+
+    // Zone names are string literals and need no escaping. Times are in
+    // microseconds, to the nanosecond. Zones which allocated show how much.
+    for (const auto& zone : m_history) {
+        auto begin = static_cast<long long>(zone.begin);
+        auto duration = static_cast<long long>(zone.end - zone.begin);
+
+        std::snprintf(line, sizeof(line),
+                      "{\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                      "\"name\":\"%s\",\"ts\":%lld.%03lld,"
+                      "\"dur\":%lld.%03lld",
+                      zone.thread, zone.name, begin / 1000, begin % 1000,
+                      duration / 1000, duration % 1000);
+        file << separator << line;
+        separator = ",\n";
+
+        if (zone.allocations.allocations) {
+            std::snprintf(line, sizeof(line),
+                          ",\"args\":{\"allocations\":%llu,\"bytes\":%llu}",
+                          static_cast<unsigned long long>(
+                              zone.allocations.allocations),
+                          static_cast<unsigned long long>(
+                              zone.allocations.bytes));
+            file << line;
+        }
+        file << '}';
+    }
+
+    file << "\n]}\n";
+
+    if (!file) {
+        log_warn("Could not write trace: " + path);
+        return -1;
+    }
+
+    return static_cast<sf::Int64>(m_history.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::record(Zone zone)
+{
+    if (ringIndex > MaxThreads) {
+        ringIndex = addRing();
+    }
+
+    if (ringIndex == MaxThreads) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& ring = *m_rings[ringIndex];
+    auto head = ring.head.load(std::memory_order_relaxed);
+
+    if (head - ring.tail.load(std::memory_order_acquire) >= RingSize) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    zone.thread = ringIndex;
+    ring.zones[head % RingSize] = zone;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Profiler::addRing()
+{
+    AllocationTracker::Untracked untracked;
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+    auto index = m_ringCount.load(std::memory_order_relaxed);
+    if (index == MaxThreads) {
+        log_warn("Too many threads to profile");
+        return MaxThreads;
+    }
+
+    m_rings[index] = std::make_unique<Ring>();
+    m_threadNames[index] = threadName;
+    m_ringCount.store(index + 1, std::memory_order_release);
+
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Profiler::Node& Profiler::getNode(const Zone& zone)
+{
+    for (auto& node : m_nodes) {
+        if (node.path == zone.path && node.name == zone.name &&
+            node.depth == zone.depth) {
+            return node;
+        }
+    }
+
+    m_nodes.push_back({zone.name, zone.parent, zone.path, zone.parentPath,
+                       zone.depth, 0, 0, 0, {0, 0},
+                       TimeHistogram(StatisticsWindows)});
+    return m_nodes.back();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::getLines(std::vector<Line>& lines) const
+{
+    std::vector<std::size_t> order;
+    getOrder(order);
+
+    auto frames = static_cast<float>(std::max(m_frames, 1u));
+    auto ms = [](sf::Time time) {
+        return time.asSeconds() * 1000.f;
+    };
+
+    lines.clear();
+    for (auto index : order) {
+        const auto& node = m_nodes[index];
+        lines.push_back({node.name, node.parent, node.depth,
+                         static_cast<float>(node.calls) / frames,
+                         static_cast<float>(node.totalTime) / frames / 1e6f,
+                         ms(node.times.getPercentile(50.f)),
+                         ms(node.times.getPercentile(95.f)),
+                         ms(node.times.getPercentile(99.f)),
+                         ms(node.times.getMaximum()),
+                         static_cast<float>(node.allocations.allocations) /
+                         frames,
+                         static_cast<float>(node.allocations.bytes) / frames});
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::getOrder(std::vector<std::size_t>& order) const
+{
+    order.clear();
+
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        if (!m_nodes[i].depth) {
+            appendOrder(i, order);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Profiler::appendOrder(std::size_t index,
+                           std::vector<std::size_t>& order) const
+{
+    const auto& node = m_nodes[index];
+    order.push_back(index);
+
+    // Children are matched on the path of this very node, not its name,
+    // which other nodes at this depth may share
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].depth == node.depth + 1 &&
+            m_nodes[i].parentPath == node.path) {
+            appendOrder(i, order);
+        }
+    }
+}
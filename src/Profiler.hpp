@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Profiler.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Hierarchical profiler of scoped zones timed on every thread
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__PROFILER_HPP
+#define ROGUELIKE__PROFILER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <SFML/System.hpp>
+
+#include "TimeHistogram.hpp"
+#include "AllocationTracker.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Profiling
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Times the rest of the enclosing scope as a zone of the profiler
+///
+/// Zones are only timed in builds with ROGUELIKE_PROFILER defined, and this
+/// otherwise expands to nothing.
+///
+/// @param name Name of the zone, which must be a string literal
+///////////////////////////////////////////////////////////////////////////////
+#ifdef ROGUELIKE_PROFILER
+#define profile_scope(name) \
+    Profiler::Scope ROGUELIKE__PROFILER_CONCAT(profilerScope, __LINE__)(name)
+#define ROGUELIKE__PROFILER_CONCAT(a, b) ROGUELIKE__PROFILER_CONCAT2(a, b)
+#define ROGUELIKE__PROFILER_CONCAT2(a, b) a##b
+#else
+#define profile_scope(name)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Hierarchical profiler of scoped zones timed on every thread
+///
+/// Zones are timed by Scope objects and recorded, once they end, into a ring
+/// owned by the thread they ran on. Only that thread writes to its ring and
+/// only endFrame() reads it, so recording a zone takes no lock, and zones
+/// ending while their ring is full are dropped rather than wait. Only the
+/// first zone on each thread locks, to add the thread's ring.
+///
+/// endFrame() collects every ring once per frame and adds the zones' times
+/// to a node per distinct zone, identified by its name, the name of the zone
+/// it ran in and its depth, which builds up the hierarchy of zones on each
+/// thread. Zones run in jobs are roots of their worker's hierarchy.
+///
+/// The zones collected over the last few seconds are also kept, so that
+/// they can be written out as a trace when something goes wrong.
+///
+/// The time each zone took in each frame, and the time each frame took, are
+/// counted in histograms spanning the last few reports, whose percentiles
+/// show stutter that averages hide.
+///
+/// When allocations are tracked, each zone also counts the allocations made
+/// on its thread while it ran, and each frame those made on every thread.
+/// The profiler's own allocations are left uncounted.
+///////////////////////////////////////////////////////////////////////////////
+class Profiler {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of zones each thread's ring holds
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 RingSize = 1 << 14;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Maximum number of threads zones are recorded on
+    ///
+    /// Zones on any further threads are dropped.
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MaxThreads = 64;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of reports the percentiles of frame times span
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 StatisticsWindows = 10;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A timed zone
+    ///
+    /// Times are in nanoseconds since the profiler was created. parent is
+    /// the name of the zone it ran in, or null for roots. path identifies
+    /// the zone by its name and those of every zone it ran in, and
+    /// parentPath is the path of the zone it ran in, or 0 for roots. The
+    /// allocations include those of the zones which ran in it.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Zone {
+        const char* name;
+        const char* parent;
+        sf::Uint64 path;
+        sf::Uint64 parentPath;
+        sf::Int64 begin;
+        sf::Int64 end;
+        sf::Uint32 depth;
+        sf::Uint32 thread;
+        AllocationTracker::Counts allocations;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Statistics of a distinct zone
+    ///
+    /// Times are in milliseconds per frame, summing every time the zone ran
+    /// during the frame. calls and average cover the frames since the last
+    /// report, the percentiles and maximum the last StatisticsWindows
+    /// reports. allocations and bytes are per frame since the last report.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Line {
+        const char* name;
+        const char* parent;
+        sf::Uint32 depth;
+        float calls;
+        float average;
+        float p50;
+        float p95;
+        float p99;
+        float maximum;
+        float allocations;
+        float bytes;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Times a zone from its construction to its destruction
+    ///
+    /// Scopes must be destroyed on the thread which created them, in the
+    /// reverse order, as local variables are.
+    ///////////////////////////////////////////////////////////////////////////
+    class Scope {
+    public:
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Begins timing a zone
+        ///
+        /// @param name Name of the zone, which must outlive the profiler
+        ///////////////////////////////////////////////////////////////////////
+        explicit Scope(const char* name);
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Records the zone
+        ///////////////////////////////////////////////////////////////////////
+        ~Scope();
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable copy constructor
+        ///////////////////////////////////////////////////////////////////////
+        Scope(const Scope&) = delete;
+
+        ///////////////////////////////////////////////////////////////////////
+        /// @brief Disable assignment operator
+        ///////////////////////////////////////////////////////////////////////
+        void operator=(const Scope&) = delete;
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        const char* m_name;
+        Scope* m_parent;
+        sf::Uint32 m_depth;
+        sf::Uint64 m_path;
+        sf::Int64 m_begin;
+        AllocationTracker::Counts m_allocations;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    Profiler();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    Profiler(const Profiler&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const Profiler&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Names the calling thread in traces
+    ///
+    /// This must be called before the thread's first zone, and threads which
+    /// are not named are numbered instead.
+    ///
+    /// @param name Name of the thread, which must outlive the profiler
+    ///////////////////////////////////////////////////////////////////////////
+    static void setThreadName(const char* name);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Sets how long collected zones are kept for traces
+    ///
+    /// @param history  Time to keep zones for after they end, 0 to keep none
+    ///////////////////////////////////////////////////////////////////////////
+    void setHistory(sf::Time history);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the current time
+    ///
+    /// @return Nanoseconds since the profiler was created
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Int64 now() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Collects the zones recorded since the last frame
+    ///
+    /// This should be called once per frame, from the main thread and
+    /// outside of any zone.
+    ///
+    /// @param frameTime    Time the frame took
+    ///////////////////////////////////////////////////////////////////////////
+    void endFrame(sf::Time frameTime);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the zones collected by the last endFrame()
+    ///
+    /// @return Zones of each thread, in the order they ended
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<Zone>& getFrameZones() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the allocations made during the last frame
+    ///
+    /// @return Allocations on every thread between the last two endFrame()
+    ///         calls
+    ///////////////////////////////////////////////////////////////////////////
+    const AllocationTracker::Counts& getFrameAllocations() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reports the statistics of every zone and starts them over
+    ///
+    /// The oldest window of every histogram is dropped for a new one.
+    ///
+    /// @param lines    Set to a line per distinct zone, each followed by the
+    ///                 lines of the zones which ran in it
+    ///
+    /// @return Number of frames since the last report
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 report(std::vector<Line>& lines);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the histogram of the frames' times
+    ///
+    /// @return Histogram spanning the last StatisticsWindows reports
+    ///////////////////////////////////////////////////////////////////////////
+    const TimeHistogram& getFrameTimes() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the percentiles of the frame and zone times as CSV
+    ///
+    /// There is a row for the frames and then one per distinct zone, whose
+    /// parent is the names of the zones it ran in, outermost first and
+    /// separated by " > ". Times are in milliseconds per frame over the last
+    /// StatisticsWindows reports, or over every frame if there have been
+    /// none. Allocations are per frame since the last report.
+    ///
+    /// @param path Path of the file
+    ///
+    /// @return True if the file was written, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool writeStatistics(const std::string& path) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of zones which could not be recorded
+    ///
+    /// @return Number of zones dropped since the profiler was created
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint64 getDroppedCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the kept zones as a Chrome trace
+    ///
+    /// The file holds trace events in the JSON format read by
+    /// chrome://tracing and Perfetto, with a track per thread.
+    ///
+    /// @param path Path of the file
+    ///
+    /// @return Number of zones written, or -1 if the file was not written
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Int64 writeTrace(const std::string& path) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Ring of the zones recorded on a thread
+    ///
+    /// head is only written by the owning thread and tail by endFrame(), so
+    /// the zones between them can be read without a lock.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Ring {
+        std::vector<Zone> zones = std::vector<Zone>(RingSize);
+        std::atomic<sf::Uint64> head{0};
+        std::atomic<sf::Uint64> tail{0};
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Statistics of a distinct zone
+    ///
+    /// Zones are distinct by path, so a zone which runs in several others
+    /// has a node under each of them.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Node {
+        const char* name;
+        const char* parent;
+        sf::Uint64 path;
+        sf::Uint64 parentPath;
+        sf::Uint32 depth;
+        sf::Int64 frameTime;
+        sf::Int64 totalTime;
+        sf::Uint64 calls;
+        AllocationTracker::Counts allocations;
+        TimeHistogram times;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Records an ended zone in the calling thread's ring
+    ///
+    /// @param zone The zone, whose thread is filled in
+    ///////////////////////////////////////////////////////////////////////////
+    void record(Zone zone);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a ring for the calling thread
+    ///
+    /// @return Index of the ring, or MaxThreads if there are too many threads
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 addRing();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the node of a zone, adding it if it is new
+    ///
+    /// There are few distinct zones, so they are searched linearly.
+    ///
+    /// @param zone The zone
+    ///
+    /// @return The node
+    ///////////////////////////////////////////////////////////////////////////
+    Node& getNode(const Zone& zone);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a line per node, each followed by those of the nodes in
+    ///        it
+    ///
+    /// @param lines    Set to the lines
+    ///////////////////////////////////////////////////////////////////////////
+    void getLines(std::vector<Line>& lines) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the indices of the nodes, each followed by those of the
+    ///        nodes in it
+    ///
+    /// @param order    Set to the indices
+    ///////////////////////////////////////////////////////////////////////////
+    void getOrder(std::vector<std::size_t>& order) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends the index of a node and those of the nodes in it
+    ///
+    /// @param index    Index of the node
+    /// @param order    Indices to append to
+    ///////////////////////////////////////////////////////////////////////////
+    void appendOrder(std::size_t index, std::vector<std::size_t>& order) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::chrono::steady_clock::time_point m_epoch;
+    mutable std::mutex m_ringsMutex;
+    std::array<std::unique_ptr<Ring>, MaxThreads> m_rings;
+    std::atomic<sf::Uint32> m_ringCount{0};
+    std::atomic<sf::Uint64> m_dropped{0};
+    std::array<const char*, MaxThreads> m_threadNames = {};
+    std::vector<Zone> m_frameZones;
+    std::deque<Zone> m_history;
+    sf::Int64 m_historyNs = 0;
+    std::vector<Node> m_nodes;
+    TimeHistogram m_frameTimes;
+    sf::Uint32 m_frames = 0;
+    AllocationTracker::Counts m_allocationMark = {0, 0};
+    AllocationTracker::Counts m_frameAllocations = {0, 0};
+    AllocationTracker::Counts m_reportAllocations = {0, 0};
+};
+
+#endif
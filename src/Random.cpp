@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Random.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Seeded pseudo-random number generator
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Random.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+Random::Random(sf::Uint32 seed)
+{
+    this->seed(seed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void Random::seed(sf::Uint32 seed)
+{
+    m_seed = seed;
+
+    // splitmix64, which never gives the all-zero state xorshift can't leave
+    auto z = static_cast<sf::Uint64>(seed) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    m_state = (z ^ (z >> 31)) | 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Random::getSeed() const
+{
+    return m_seed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Random::next()
+{
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+
+    return static_cast<sf::Uint32>((m_state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Random::below(sf::Uint32 bound)
+{
+    if (!bound) {
+        log_exit("Random bound must not be 0");
+    }
+
+    // Scaling rather than taking the remainder uses the better high bits
+    return static_cast<sf::Uint32>(
+        (static_cast<sf::Uint64>(next()) * bound) >> 32);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int Random::between(int min, int max)
+{
+    if (max < min) {
+        log_exit("Invalid random range: " + std::to_string(min) + " to " +
+                 std::to_string(max));
+    }
+
+    auto span = static_cast<sf::Uint64>(static_cast<sf::Int64>(max) - min) + 1;
+    auto offset = (static_cast<sf::Uint64>(next()) * span) >> 32;
+
+    return static_cast<int>(min + static_cast<sf::Int64>(offset));
+}
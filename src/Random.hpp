@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   Random.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Seeded pseudo-random number generator
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__RANDOM_HPP
+#define ROGUELIKE__RANDOM_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Seeded pseudo-random number generator
+///
+/// Unlike rand(), the sequence only depends on the seed, so a session can be
+/// played out again exactly by reusing its seed. The generator is an
+/// xorshift64* whose state is derived from the seed with splitmix64, so
+/// nearby seeds still give unrelated sequences.
+///////////////////////////////////////////////////////////////////////////////
+class Random {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///
+    /// @param seed Seed of the sequence
+    ///////////////////////////////////////////////////////////////////////////
+    explicit Random(sf::Uint32 seed = 0);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Restarts the sequence from a seed
+    ///
+    /// @param seed Seed of the sequence
+    ///////////////////////////////////////////////////////////////////////////
+    void seed(sf::Uint32 seed);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the seed the sequence was started from
+    ///
+    /// @return The seed
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getSeed() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the next number of the sequence
+    ///
+    /// @return A number in [0, 2^32)
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 next();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number below a bound
+    ///
+    /// @param bound    Bound of the number, which must not be 0
+    ///
+    /// @return A number in [0, bound)
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 below(sf::Uint32 bound);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number within a range
+    ///
+    /// @param min  Smallest possible number
+    /// @param max  Largest possible number, which must not be less than min
+    ///
+    /// @return A number in [min, max]
+    ///////////////////////////////////////////////////////////////////////////
+    int between(int min, int max);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 m_seed;
+    sf::Uint64 m_state;
+};
+
+#endif
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderBatch.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Streaming vertex buffer which merges consecutive draws that share
+///         a texture and blend mode into a single draw call
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderBatch.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "State.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderBatch::begin(sf::RenderTarget& target)
+{
+    m_target = &target;
+    m_vertices.clear();
+    m_states = sf::RenderStates();
+    m_drawCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::vector<sf::Vertex>& RenderBatch::getVertices(
+    const sf::Texture* texture, const sf::BlendMode& blendMode)
+{
+    if (texture != m_states.texture || blendMode != m_states.blendMode) {
+        flush();
+        m_states.texture = texture;
+        m_states.blendMode = blendMode;
+    }
+
+    return m_vertices;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderBatch::flush()
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+
+    if (!m_target) {
+        log_exit("RenderBatch was not begun");
+    }
+
+    State::get().renderStats.draw(*m_target, m_vertices.data(),
+                                  m_vertices.size(), sf::Quads, m_states);
+    m_vertices.clear();
+    ++m_drawCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 RenderBatch::getDrawCount() const
+{
+    return m_drawCount;
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderBatch.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Streaming vertex buffer which merges consecutive draws that share
+///         a texture and blend mode into a single draw call
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__RENDER_BATCH_HPP
+#define ROGUELIKE__RENDER_BATCH_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Streaming vertex buffer which merges consecutive draws that share
+///        a texture and blend mode into a single draw call
+///
+/// Geometry is appended already transformed into the target's coordinates as
+/// quads, in the order it should be drawn. Whenever geometry with a different
+/// texture or blend mode is appended, the pending geometry is drawn first, so
+/// the draw order is always kept and the number of draw calls is the number
+/// of changes of texture or blend mode. The buffer keeps its capacity between
+/// frames, so it stops allocating once it has grown to fit a frame.
+///////////////////////////////////////////////////////////////////////////////
+class RenderBatch {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderBatch() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderBatch(const RenderBatch&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const RenderBatch&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Starts batching draws to a target
+    ///
+    /// @param target   Target to draw the batched geometry to
+    ///////////////////////////////////////////////////////////////////////////
+    void begin(sf::RenderTarget& target);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the buffer to append quads using a texture and blend
+    ///        mode to
+    ///
+    /// If the pending quads use a different texture or blend mode they are
+    /// drawn first.
+    ///
+    /// @param texture      Texture of the quads, may be nullptr
+    /// @param blendMode    Blend mode of the quads
+    ///
+    /// @return Buffer to append the quads' vertices to
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<sf::Vertex>& getVertices(
+        const sf::Texture* texture,
+        const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Draws any pending quads
+    ///
+    /// This must be called before drawing to the target by other means, and
+    /// after the last quads of a frame have been appended.
+    ///////////////////////////////////////////////////////////////////////////
+    void flush();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of draw calls made since begin()
+    ///
+    /// @return Number of draw calls
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getDrawCount() const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::RenderTarget* m_target = nullptr;
+    std::vector<sf::Vertex> m_vertices;
+    sf::RenderStates m_states;
+    sf::Uint32 m_drawCount = 0;
+};
+
+#endif
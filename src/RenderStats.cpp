@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderStats.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Counts of the draw calls, vertices and state changes submitted
+///         while rendering
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderStats.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderStats::draw(sf::RenderTarget& target, const sf::Vertex* vertices,
+                       std::size_t vertexCount, sf::PrimitiveType type,
+                       const sf::RenderStates& states)
+{
+    count(target, vertexCount, states.texture);
+    target.draw(vertices, vertexCount, type, states);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderStats::draw(sf::RenderTarget& target,
+                       const sf::VertexArray& vertices,
+                       const sf::RenderStates& states)
+{
+    count(target, vertices.getVertexCount(), states.texture);
+    target.draw(vertices, states);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderStats::draw(sf::RenderTarget& target, const sf::Sprite& sprite,
+                       const sf::RenderStates& states)
+{
+    // The sprite draws with its own texture, whatever the states hold
+    count(target, 4, sprite.getTexture());
+    target.draw(sprite, states);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderStats::endFrame()
+{
+    m_frame = {m_total.drawCalls - m_mark.drawCalls,
+               m_total.vertices - m_mark.vertices,
+               m_total.textureSwitches - m_mark.textureSwitches,
+               m_total.targetSwitches - m_mark.targetSwitches};
+    m_mark = m_total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const RenderStats::Counts& RenderStats::getFrameCounts() const
+{
+    return m_frame;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const RenderStats::Counts& RenderStats::getTotalCounts() const
+{
+    return m_total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderStats::count(const sf::RenderTarget& target,
+                        std::size_t vertexCount, const sf::Texture* texture)
+{
+    // SFML draws nothing without vertices, so neither is a draw call
+    if (!vertexCount) {
+        return;
+    }
+
+    ++m_total.drawCalls;
+    m_total.vertices += vertexCount;
+
+    if (texture != m_lastTexture) {
+        ++m_total.textureSwitches;
+        m_lastTexture = texture;
+    }
+    if (&target != m_lastTarget) {
+        ++m_total.targetSwitches;
+        m_lastTarget = &target;
+    }
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderStats.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Counts of the draw calls, vertices and state changes submitted
+///         while rendering
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__RENDER_STATS_HPP
+#define ROGUELIKE__RENDER_STATS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Counts of the draw calls, vertices and state changes submitted
+///        while rendering
+///
+/// The draws which submit geometry go through draw(), which counts them and
+/// then draws as the target would. Drawables which only draw others, such as
+/// windows and managers, are drawn directly, so that nothing is counted
+/// twice.
+///
+/// A texture switch is a draw with another texture than the draw before it,
+/// and a target switch a draw to another target, which makes SFML activate
+/// that target's context. The fewer of each, the better the batching.
+///
+/// Only the main thread draws through the counts, so they aren't locked.
+/// Totals only ever grow, so the draws over any stretch of time are the
+/// difference between the totals before and after it.
+///////////////////////////////////////////////////////////////////////////////
+class RenderStats {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Numbers of draws and of what they submitted
+    ///////////////////////////////////////////////////////////////////////////
+    struct Counts {
+        sf::Uint64 drawCalls;
+        sf::Uint64 vertices;
+        sf::Uint64 textureSwitches;
+        sf::Uint64 targetSwitches;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderStats() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderStats(const RenderStats&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const RenderStats&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Draws and counts primitives
+    ///
+    /// @param target       Target to draw to
+    /// @param vertices     Vertices of the primitives
+    /// @param vertexCount  Number of vertices
+    /// @param type         Type of the primitives
+    /// @param states       States to draw with
+    ///////////////////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target, const sf::Vertex* vertices,
+              std::size_t vertexCount, sf::PrimitiveType type,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Draws and counts a vertex array
+    ///
+    /// @param target   Target to draw to
+    /// @param vertices The vertex array
+    /// @param states   States to draw with
+    ///////////////////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target, const sf::VertexArray& vertices,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Draws and counts a sprite
+    ///
+    /// @param target   Target to draw to
+    /// @param sprite   The sprite, which is drawn as 4 vertices
+    /// @param states   States to draw with
+    ///////////////////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target, const sf::Sprite& sprite,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Ends the frame, whose counts are kept until the next
+    ///
+    /// This should be called once per frame, after it has been drawn.
+    ///////////////////////////////////////////////////////////////////////////
+    void endFrame();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the draws of the last frame
+    ///
+    /// @return Draws between the last two endFrame() calls
+    ///////////////////////////////////////////////////////////////////////////
+    const Counts& getFrameCounts() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the draws since the counts were created
+    ///
+    /// @return Total draws
+    ///////////////////////////////////////////////////////////////////////////
+    const Counts& getTotalCounts() const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Counts a draw
+    ///
+    /// @param target       Target drawn to
+    /// @param vertexCount  Number of vertices drawn
+    /// @param texture      Texture drawn with, may be nullptr
+    ///////////////////////////////////////////////////////////////////////////
+    void count(const sf::RenderTarget& target, std::size_t vertexCount,
+               const sf::Texture* texture);
+
+    ///////////////////////////////////////////////////////////////////////////
+    Counts m_total = {0, 0, 0, 0};
+    Counts m_mark = {0, 0, 0, 0};
+    Counts m_frame = {0, 0, 0, 0};
+    const sf::RenderTarget* m_lastTarget = nullptr;
+    const sf::Texture* m_lastTexture = nullptr;
+};
+
+#endif
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderThread.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Presents composed frames to the game window on its own thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderThread.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Common.hpp"
+#include "Profiler.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RenderThread::start(sf::RenderWindow& window,
+                         const sf::Vector2u& frameSize)
+{
+    if (m_running) {
+        log_exit("Render thread already running");
+    }
+
+    for (auto& snapshot : m_snapshots) {
+        snapshot.texture = std::make_unique<sf::Texture>();
+        if (!snapshot.texture->create(frameSize.x, frameSize.y)) {
+            return false;
+        }
+    }
+
+    m_back = 0;
+    m_front = 1;
+    m_middle = 2;
+    m_window = &window;
+
+    // A context can only be active on one thread at a time
+    window.setActive(false);
+
+    m_running = true;
+    m_thread = std::thread(&RenderThread::run, this);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderThread::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_running = false;
+    signal();
+    m_thread.join();
+
+    m_window->setActive(true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RenderThread::isRunning() const
+{
+    return m_running;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderThread::submit(const sf::Texture& frame, const sf::Vector2f& scale,
+                          const sf::Vector2u& windowSize)
+{
+    if (!m_running) {
+        log_exit("Render thread is not running");
+    }
+
+    // Copying flushes, so the snapshot is complete in the render thread's
+    // context by the time it is swapped in
+    m_snapshots[m_back].texture->update(frame);
+    m_snapshots[m_back].scale = scale;
+    m_snapshots[m_back].windowSize = windowSize;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] {
+            return !(m_middle & NewSnapshot);
+        });
+    }
+
+    m_back = m_middle.exchange(m_back | NewSnapshot);
+    signal();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool RenderThread::pollEvent(sf::Event& event)
+{
+    // The window may have been closed along with stopping
+    if (!m_running) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_windowMutex);
+    return m_window->pollEvent(event);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderThread::run()
+{
+    Profiler::setThreadName("Render");
+    m_window->setActive(true);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] {
+                return (m_middle & NewSnapshot) || !m_running;
+            });
+        }
+
+        if (!m_running) {
+            break;
+        }
+
+        m_front = m_middle.exchange(m_front) & ~NewSnapshot;
+        signal();
+
+        profile_scope("RenderThread::present");
+        const auto& snapshot = m_snapshots[m_front];
+        sf::Sprite sprite(*snapshot.texture);
+        sprite.setScale(snapshot.scale);
+
+        // The view maps the window's pixels one to one, as the scale
+        // expects
+        {
+            std::lock_guard<std::mutex> lock(m_windowMutex);
+            m_window->setView(sf::View(sf::FloatRect(
+                0.f, 0.f, static_cast<float>(snapshot.windowSize.x),
+                static_cast<float>(snapshot.windowSize.y))));
+            m_window->draw(sprite);
+        }
+
+        m_window->display();
+    }
+
+    m_window->setActive(false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void RenderThread::signal()
+{
+    // Taking the lock orders this with the waiting thread checking its
+    // condition, so the wakeup can't slip in between the check and the wait
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_all();
+}
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   RenderThread.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Presents composed frames to the game window on its own thread
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__RENDER_THREAD_HPP
+#define ROGUELIKE__RENDER_THREAD_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Presents composed frames to the game window on its own thread
+///
+/// Drawing to the window and waiting on display() for vsync or the frame
+/// limit happens on the render thread, so the main thread can simulate and
+/// compose the next frame at the same time. Each submitted frame is copied
+/// into a snapshot which the main thread no longer touches, and snapshots
+/// are handed over through a lock-free triple buffer: the main thread fills
+/// the back snapshot, then atomically swaps it with the middle one, which
+/// the render thread in turn swaps with the front snapshot it presents. The
+/// mutex and condition variable are only used to sleep while waiting.
+///
+/// Once started, the game window's OpenGL context belongs to the render
+/// thread, so the window must not be drawn to or closed from elsewhere until
+/// stop() is called. Its events must be polled through pollEvent(), since
+/// handling a resize changes the window's size and view, which drawing
+/// reads. The render thread sets the view itself, from the window size
+/// handed over with each frame, rather than use what the resize left.
+///////////////////////////////////////////////////////////////////////////////
+class RenderThread {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of snapshots in the triple buffer
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 SnapshotCount = 3;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderThread() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Destructor, which stops the thread
+    ///////////////////////////////////////////////////////////////////////////
+    ~RenderThread();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    RenderThread(const RenderThread&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const RenderThread&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Starts presenting to a window
+    ///
+    /// This must be called from the thread the window's context is active
+    /// on, which gives it up to the render thread.
+    ///
+    /// @param window       Window to present to, which must outlive the thread
+    /// @param frameSize    Size of the frames which will be submitted
+    ///
+    /// @return False if the snapshots could not be created
+    ///////////////////////////////////////////////////////////////////////////
+    bool start(sf::RenderWindow& window, const sf::Vector2u& frameSize);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Stops presenting and waits for the render thread to finish
+    ///
+    /// Frames submitted but not yet presented are dropped. Does nothing if
+    /// the thread is not running.
+    ///////////////////////////////////////////////////////////////////////////
+    void stop();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether the render thread is running
+    ///
+    /// @return True if started and not stopped, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool isRunning() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Hands a frame over to be presented
+    ///
+    /// The frame is copied, so it may be changed as soon as this returns.
+    /// If the previous frame hasn't been picked up yet, this waits until it
+    /// has, which keeps the main thread at most one frame ahead of the
+    /// display.
+    ///
+    /// @param frame        Texture holding the frame, of the size given to
+    ///                     start()
+    /// @param scale        Scale to draw the frame to the window with
+    /// @param windowSize   Size of the window, as of the last resize handled
+    ///////////////////////////////////////////////////////////////////////////
+    void submit(const sf::Texture& frame, const sf::Vector2f& scale,
+                const sf::Vector2u& windowSize);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Pops an event of the window, without it being drawn to
+    ///
+    /// This is the window's pollEvent(), made safe to call while the render
+    /// thread runs.
+    ///
+    /// @param event    Event to fill in
+    ///
+    /// @return True if an event was popped, false otherwise or if the
+    ///         thread is not running
+    ///////////////////////////////////////////////////////////////////////////
+    bool pollEvent(sf::Event& event);
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Set in the middle index once a new snapshot has been swapped in
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 NewSnapshot = 0x4;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A submitted frame
+    ///
+    /// The texture is only created by start(), as constructing one needs a
+    /// display, which headless games don't have.
+    ///////////////////////////////////////////////////////////////////////////
+    struct Snapshot {
+        std::unique_ptr<sf::Texture> texture;
+        sf::Vector2f scale;
+        sf::Vector2u windowSize;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Presents new snapshots until stopped, on the render thread
+    ///////////////////////////////////////////////////////////////////////////
+    void run();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Wakes the other thread if it is waiting
+    ///////////////////////////////////////////////////////////////////////////
+    void signal();
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::array<Snapshot, SnapshotCount> m_snapshots;
+    sf::Uint32 m_back = 0;
+    sf::Uint32 m_front = 1;
+    std::atomic<sf::Uint32> m_middle{2};
+    std::atomic<bool> m_running{false};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::mutex m_windowMutex;
+    sf::RenderWindow* m_window = nullptr;
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   SpatialIndex.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Grid-based index of entity positions supporting point, rectangle,
+///         radius and line queries
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SpatialIndex.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::create(const sf::Vector2u& area)
+{
+    m_area = area;
+    m_bucketArea = {(area.x + BucketSize - 1) / BucketSize,
+                    (area.y + BucketSize - 1) / BucketSize};
+    m_nodes.clear();
+    m_heads.assign(area.x * area.y, None);
+    m_bucketCounts.assign(m_bucketArea.x * m_bucketArea.y, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::reserve(std::size_t count)
+{
+    m_nodes.reserve(count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::insert(Entity entity, const sf::Vector2u& coord)
+{
+    if (coord.x >= m_area.x || coord.y >= m_area.y) {
+        log_exit("Coordinate is outside of the SpatialIndex");
+    }
+
+    if (entity.index >= m_nodes.size()) {
+        m_nodes.resize(entity.index + 1);
+    }
+    else if (m_nodes[entity.index].tile != None) {
+        log_exit("Entity is already indexed: " +
+                 std::to_string(entity.index));
+    }
+
+    m_nodes[entity.index].entity = entity;
+    link(entity.index, (coord.y * m_area.x) + coord.x);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::remove(Entity entity)
+{
+    if (!contains(entity)) {
+        log_warn("Entity is not indexed: " + std::to_string(entity.index));
+        return;
+    }
+
+    unlink(entity.index);
+    m_nodes[entity.index].tile = None;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::move(Entity entity, const sf::Vector2u& coord)
+{
+    if (coord.x >= m_area.x || coord.y >= m_area.y) {
+        log_exit("Coordinate is outside of the SpatialIndex");
+    }
+    else if (!contains(entity)) {
+        log_exit("Entity is not indexed: " + std::to_string(entity.index));
+    }
+
+    auto tile = (coord.y * m_area.x) + coord.x;
+    if (m_nodes[entity.index].tile != tile) {
+        unlink(entity.index);
+        link(entity.index, tile);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool SpatialIndex::contains(Entity entity) const
+{
+    return entity.index < m_nodes.size() &&
+           m_nodes[entity.index].tile != None &&
+           m_nodes[entity.index].entity == entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool SpatialIndex::isOccupied(const sf::Vector2u& coord) const
+{
+    return coord.x < m_area.x && coord.y < m_area.y &&
+           m_heads[(coord.y * m_area.x) + coord.x] != None;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 SpatialIndex::getBucket(sf::Uint32 tile) const
+{
+    return ((tile / m_area.x) / BucketSize) * m_bucketArea.x +
+           ((tile % m_area.x) / BucketSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::link(sf::Uint32 index, sf::Uint32 tile)
+{
+    auto& node = m_nodes[index];
+    node.tile = tile;
+    node.prev = None;
+    node.next = m_heads[tile];
+
+    if (node.next != None) {
+        m_nodes[node.next].prev = index;
+    }
+    m_heads[tile] = index;
+
+    ++m_bucketCounts[getBucket(tile)];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SpatialIndex::unlink(sf::Uint32 index)
+{
+    auto& node = m_nodes[index];
+
+    if (node.prev != None) {
+        m_nodes[node.prev].next = node.next;
+    }
+    else {
+        m_heads[node.tile] = node.next;
+    }
+
+    if (node.next != None) {
+        m_nodes[node.next].prev = node.prev;
+    }
+
+    --m_bucketCounts[getBucket(node.tile)];
+}
@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   SpatialIndex.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Grid-based index of entity positions supporting point, rectangle,
+///         radius and line queries
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__SPATIAL_INDEX_HPP
+#define ROGUELIKE__SPATIAL_INDEX_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+#include "EntityStore.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Index of which entities occupy which tiles
+///
+/// Every tile holds the head of an intrusive, doubly linked list of the
+/// entities occupying it, with the links stored in an array indexed by
+/// Entity::index, so inserting, moving and removing an entity are O(1) and
+/// never allocate once the array has grown to fit the entity indices in use.
+/// The tiles are also grouped into square buckets which count their
+/// occupants so that area queries can skip over empty regions entirely.
+///
+/// Queries call a function for each entity found and never allocate.
+///////////////////////////////////////////////////////////////////////////////
+class SpatialIndex {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Width and height of a bucket in tiles
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 BucketSize = 8;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor, create() must be called before use
+    ///////////////////////////////////////////////////////////////////////////
+    SpatialIndex() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    SpatialIndex(const SpatialIndex&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const SpatialIndex&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief (Re)creates an empty SpatialIndex
+    ///
+    /// @param area Width and height of the indexed area in # of tiles
+    ///////////////////////////////////////////////////////////////////////////
+    void create(const sf::Vector2u& area);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reserves space for entity indices to avoid later reallocation
+    ///
+    /// @param count    Number of entity indices to reserve space for
+    ///////////////////////////////////////////////////////////////////////////
+    void reserve(std::size_t count);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds an entity at a coord
+    ///
+    /// The entity is placed on top of any entities already at the coord.
+    ///
+    /// @param entity   Handle of the entity
+    /// @param coord    Coordinate of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    void insert(Entity entity, const sf::Vector2u& coord);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes an entity
+    ///
+    /// @param entity   Handle of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    void remove(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves an entity to a new coord
+    ///
+    /// @param entity   Handle of the entity
+    /// @param coord    New coordinate of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    void move(Entity entity, const sf::Vector2u& coord);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not an entity is in the index
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return True if the entity is in the index, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool contains(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not any entity occupies a coord
+    ///
+    /// @param coord    Coordinate to check
+    ///
+    /// @return True if any entity occupies the coord, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool isOccupied(const sf::Vector2u& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls function(Entity) for each entity at a coord, topmost first
+    ///
+    /// @param coord    Coordinate to query
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void forEachAt(const sf::Vector2u& coord, Function&& function) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls function(Entity) for each entity within a rectangle
+    ///
+    /// @param rect     Rectangle, in tiles, to query. Parts of it outside of
+    ///                 the indexed area are ignored.
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void forEachInRect(const sf::IntRect& rect, Function&& function) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls function(Entity) for each entity within a radius
+    ///
+    /// @param center   Coordinate at the center of the circle
+    /// @param radius   Radius of the circle in tiles (inclusive)
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void forEachInRadius(const sf::Vector2u& center,
+                         sf::Uint32 radius,
+                         Function&& function) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls function(Entity) for each entity on a line of tiles
+    ///
+    /// Tiles are visited in order from the start of the line to the end of
+    /// the line (both inclusive).
+    ///
+    /// @param from     Coordinate at the start of the line
+    /// @param to       Coordinate at the end of the line
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void forEachOnLine(const sf::Vector2u& from,
+                       const sf::Vector2u& to,
+                       Function&& function) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks the end of a list / an entity not in the index
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 None = 0xFFFFFFFF;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Links of an entity in the list of the tile it occupies
+    ///////////////////////////////////////////////////////////////////////////
+    struct Node {
+        Entity entity = {None, 0};
+        sf::Uint32 tile = None;
+        sf::Uint32 next = None;
+        sf::Uint32 prev = None;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Calls function(Entity) for each entity in a tile
+    ///
+    /// @param tile     Index of the tile
+    /// @param function Function to call
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename Function>
+    void visitTile(sf::Uint32 tile, Function& function) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the bucket containing a tile
+    ///
+    /// @param tile Index of the tile
+    ///
+    /// @return Index of the bucket
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getBucket(sf::Uint32 tile) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Links a node at the head of a tile's list
+    ///
+    /// @param index    Index of the node
+    /// @param tile     Index of the tile
+    ///////////////////////////////////////////////////////////////////////////
+    void link(sf::Uint32 index, sf::Uint32 tile);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Unlinks a node from its tile's list
+    ///
+    /// @param index    Index of the node
+    ///////////////////////////////////////////////////////////////////////////
+    void unlink(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Vector2u m_area;
+    sf::Vector2u m_bucketArea;
+    std::vector<Node> m_nodes;
+    std::vector<sf::Uint32> m_heads;
+    std::vector<sf::Uint32> m_bucketCounts;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Template implementation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void SpatialIndex::forEachAt(const sf::Vector2u& coord,
+                             Function&& function) const
+{
+    if (coord.x < m_area.x && coord.y < m_area.y) {
+        visitTile((coord.y * m_area.x) + coord.x, function);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void SpatialIndex::forEachInRect(const sf::IntRect& rect,
+                                 Function&& function) const
+{
+    auto left = std::max(rect.left, 0);
+    auto top = std::max(rect.top, 0);
+    auto right = std::min(rect.left + rect.width,
+                          static_cast<int>(m_area.x));
+    auto bottom = std::min(rect.top + rect.height,
+                           static_cast<int>(m_area.y));
+
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    auto size = static_cast<int>(BucketSize);
+    for (auto by = top / size; by <= (bottom - 1) / size; ++by) {
+        for (auto bx = left / size; bx <= (right - 1) / size; ++bx) {
+            auto bucket = static_cast<sf::Uint32>(by) * m_bucketArea.x +
+                          static_cast<sf::Uint32>(bx);
+            if (!m_bucketCounts[bucket]) {
+                continue;
+            }
+
+            auto y0 = std::max(top, by * size);
+            auto y1 = std::min(bottom, (by + 1) * size);
+            auto x0 = std::max(left, bx * size);
+            auto x1 = std::min(right, (bx + 1) * size);
+
+            for (auto y = y0; y < y1; ++y) {
+                auto row = static_cast<sf::Uint32>(y) * m_area.x;
+                for (auto x = x0; x < x1; ++x) {
+                    visitTile(row + static_cast<sf::Uint32>(x), function);
+                }
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void SpatialIndex::forEachInRadius(const sf::Vector2u& center,
+                                   sf::Uint32 radius,
+                                   Function&& function) const
+{
+    auto cx = static_cast<int>(center.x);
+    auto cy = static_cast<int>(center.y);
+    auto r = static_cast<int>(radius);
+
+    auto visitWithinRadius = [this, cx, cy, r, &function](Entity entity) {
+        const auto& node = m_nodes[entity.index];
+        auto dx = static_cast<int>(node.tile % m_area.x) - cx;
+        auto dy = static_cast<int>(node.tile / m_area.x) - cy;
+
+        if ((dx * dx) + (dy * dy) <= r * r) {
+            function(entity);
+        }
+    };
+
+    forEachInRect({cx - r, cy - r, (2 * r) + 1, (2 * r) + 1},
+                  visitWithinRadius);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void SpatialIndex::forEachOnLine(const sf::Vector2u& from,
+                                 const sf::Vector2u& to,
+                                 Function&& function) const
+{
+    // Bresenham's line algorithm
+    auto x = static_cast<int>(from.x);
+    auto y = static_cast<int>(from.y);
+    auto x1 = static_cast<int>(to.x);
+    auto y1 = static_cast<int>(to.y);
+    auto dx = std::abs(x1 - x);
+    auto dy = -std::abs(y1 - y);
+    auto sx = x < x1 ? 1 : -1;
+    auto sy = y < y1 ? 1 : -1;
+    auto error = dx + dy;
+
+    while (true) {
+        if (x >= 0 && y >= 0 &&
+            x < static_cast<int>(m_area.x) && y < static_cast<int>(m_area.y)) {
+            visitTile(static_cast<sf::Uint32>(y) * m_area.x +
+                      static_cast<sf::Uint32>(x), function);
+        }
+
+        if (x == x1 && y == y1) {
+            break;
+        }
+
+        auto doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x += sx;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y += sy;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename Function>
+void SpatialIndex::visitTile(sf::Uint32 tile, Function& function) const
+{
+    // The next link is read first so the function may remove the entity
+    auto index = m_heads[tile];
+    while (index != None) {
+        auto next = m_nodes[index].next;
+        function(m_nodes[index].entity);
+        index = next;
+    }
+}
+
+#endif
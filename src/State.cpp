@@ -55,13 +55,27 @@ State& State::get()
 ///////////////////////////////////////////////////////////////////////////////
 void State::update()
 {
-    zoneManager->update();
-    debugManager->update();
-    windowManager->update();
+    // Windows read what the zone did this step (and both read and consume
+    // the same input), so the managers update in order, and the work inside
+    // them is spread over jobSystem instead
+    {
+        profile_scope("ZoneManager::update");
+        zoneManager->update();
+    }
+    {
+        profile_scope("WindowManager::update");
+        windowManager->update();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-State::State() : windowManager(new WindowManager())
+void State::interpolate(float alpha)
+{
+    zoneManager->interpolate(alpha);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+State::State() : windowManager(new WindowManager()), messageLog(64)
 {
     // Load font
     if (!font.loadFromFile(fontFile)) {
@@ -74,6 +88,9 @@ State::State() : windowManager(new WindowManager())
 
     // Set default keybindings
     m_keyMappings = defaultKeyMappings;
+    updateKeyLookup();
+    clearAllKeyStatuses();
+    clearAllKeyPressedStatuses();
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -83,17 +100,107 @@ bool State::getKeyStatus(Key key)
 }
 
 ///////////////////////////////////////////////////////////////////////////
-void State::updateKeyStatuses()
+void State::handleEvent(const sf::Event& event)
 {
-    for (size_t i = 0; i < static_cast<size_t>(Key::Count); ++i) {
-        m_keyStatuses[i] = sf::Keyboard::isKeyPressed(m_keyMappings[i]);
+    InputEvent input = {m_inputClock.getElapsedTime().asMicroseconds(),
+                        InputEvent::KeyPressed, Key::Count,
+                        MouseButton::Count, 0.f};
+
+    switch (event.type) {
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            input.key = getKey(event.key.code);
+            if (input.key == Key::Count) {
+                return;
+            }
+            input.type = event.type == sf::Event::KeyPressed
+                ? InputEvent::KeyPressed : InputEvent::KeyReleased;
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                input.button = MouseButton::Left;
+            }
+            else if (event.mouseButton.button == sf::Mouse::Right) {
+                input.button = MouseButton::Right;
+            }
+            else {
+                return;
+            }
+            input.type = event.type == sf::Event::MouseButtonPressed
+                ? InputEvent::MousePressed : InputEvent::MouseReleased;
+            break;
+        case sf::Event::MouseWheelScrolled:
+            input.type = InputEvent::Scrolled;
+            input.delta = event.mouseWheelScroll.delta;
+            break;
+        case sf::Event::LostFocus:
+            input.type = InputEvent::FocusLost;
+            break;
+        default:
+            return;
     }
+
+    handleInputEvent(input);
+}
+
+///////////////////////////////////////////////////////////////////////////
+void State::handleInputEvent(const InputEvent& event)
+{
+    switch (event.type) {
+        case InputEvent::KeyPressed:
+        case InputEvent::KeyReleased:
+            m_keyStatuses[static_cast<size_t>(event.key)] =
+                event.type == InputEvent::KeyPressed;
+            if (event.type == InputEvent::KeyPressed) {
+                m_keyPressedStatuses[static_cast<size_t>(event.key)] = true;
+            }
+            break;
+        case InputEvent::MousePressed:
+        case InputEvent::MouseReleased:
+            m_mouseStatuses[static_cast<size_t>(event.button)] =
+                event.type == InputEvent::MousePressed;
+            if (event.type == InputEvent::MousePressed) {
+                leftClick = leftClick || event.button == MouseButton::Left;
+                rightClick = rightClick || event.button == MouseButton::Right;
+            }
+            break;
+        case InputEvent::Scrolled:
+            scrollDelta += event.delta;
+            break;
+        case InputEvent::FocusLost:
+            // Releases aren't received while unfocused, so forget what is
+            // held rather than leave keys stuck down
+            clearAllKeyStatuses();
+            break;
+        default:
+            log_exit("Invalid input event type");
+    }
+
+    m_inputEvents.push_back(event);
+}
+
+///////////////////////////////////////////////////////////////////////////
+const std::vector<InputEvent>& State::getInputEvents() const
+{
+    return m_inputEvents;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void State::clearFrameInput()
+{
+    clearAllKeyPressedStatuses();
+    leftClick = false;
+    rightClick = false;
+    scrollDelta = 0.0f;
+    m_inputEvents.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////
 void State::clearAllKeyStatuses()
 {
     m_keyStatuses.fill(false);
+    m_mouseStatuses.fill(false);
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -105,10 +212,10 @@ bool State::getKeyPressedStatus(Key key)
 ///////////////////////////////////////////////////////////////////////////
 void State::setKeyPressedStatus(sf::Keyboard::Key sfKey, bool status)
 {
-    auto it = std::find(m_keyMappings.begin(), m_keyMappings.end(), sfKey);
+    auto key = getKey(sfKey);
 
-    if (it != m_keyMappings.end()) {
-        m_keyPressedStatuses[static_cast<size_t>(*it)] = status;
+    if (key != Key::Count) {
+        m_keyPressedStatuses[static_cast<size_t>(key)] = status;
     }
 }
 
@@ -132,19 +239,15 @@ void State::rebindKey(Key key, sf::Keyboard::Key sfKey)
     else {
         m_keyMappings[static_cast<size_t>(key)] = sfKey;
     }
+
+    updateKeyLookup();
 }
 
 ///////////////////////////////////////////////////////////////////////////
 bool State::getMouseStatus(MouseButton button)
 {
-    switch (button) {
-        case MouseButton::Left:
-            return sf::Mouse::isButtonPressed(sf::Mouse::Left);
-            break;
-        case MouseButton::Right:
-            return sf::Mouse::isButtonPressed(sf::Mouse::Right);
-            break;
-    }
+    return button != MouseButton::Count &&
+           m_mouseStatuses[static_cast<size_t>(button)];
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -157,3 +260,27 @@ void State::draw(sf::RenderTarget& target, sf::RenderStates) const
         target.draw(*debugManager);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////
+Key State::getKey(sf::Keyboard::Key sfKey) const
+{
+    if (sfKey < 0 || sfKey >= sf::Keyboard::KeyCount) {
+        return Key::Count;
+    }
+
+    return m_keyLookup[static_cast<size_t>(sfKey)];
+}
+
+///////////////////////////////////////////////////////////////////////////
+void State::updateKeyLookup()
+{
+    m_keyLookup.fill(Key::Count);
+
+    for (size_t i = 0; i < static_cast<size_t>(Key::Count); ++i) {
+        if (m_keyMappings[i] >= 0 &&
+            m_keyMappings[i] < sf::Keyboard::KeyCount) {
+            m_keyLookup[static_cast<size_t>(m_keyMappings[i])] =
+                static_cast<Key>(i);
+        }
+    }
+}
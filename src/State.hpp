@@ -14,11 +14,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <array>
+#include <vector>
 #include <memory>
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
 
 #include "Common.hpp"
+#include "Random.hpp"
+#include "Profiler.hpp"
+#include "JobSystem.hpp"
+#include "MessageLog.hpp"
+#include "RenderStats.hpp"
+#include "FrameCompositor.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Enum of all keyboard inputs used by the game
@@ -33,7 +40,27 @@ enum class Key {
 /// @brief Enum describing mouse input buttons
 ///////////////////////////////////////////////////////////////////////////////
 enum class MouseButton {
-    Left, Right
+    Left, Right, Count
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief An input received from the window, in terms of the game's inputs
+///
+/// key is only meaningful for key events, button for mouse button events and
+/// delta for scroll events. time is in microseconds since the State was
+/// created.
+///////////////////////////////////////////////////////////////////////////////
+struct InputEvent {
+    enum Type {
+        KeyPressed, KeyReleased, MousePressed, MouseReleased, Scrolled,
+        FocusLost, Count
+    };
+
+    sf::Int64 time;
+    Type type;
+    Key key;
+    MouseButton button;
+    float delta;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -71,9 +98,23 @@ public:
 
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates all private management classes
+    ///
+    /// This advances the simulation by one step of deltaMs.
     ///////////////////////////////////////////////////////////////////////////
     void update();
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Prepares the frame about to be rendered
+    ///
+    /// Frames are usually rendered between two simulation steps, so anything
+    /// which moves smoothly is drawn part of the way towards where the last
+    /// step put it.
+    ///
+    /// @param alpha    How far the frame is from the last step to the next,
+    ///                 in [0, 1)
+    ///////////////////////////////////////////////////////////////////////////
+    void interpolate(float alpha);
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Returns pressed status of a given key
     ///
@@ -84,14 +125,46 @@ public:
     bool getKeyStatus(Key key);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Sets the pressed status of all keys based on sf::Keyboard
+    /// @brief Updates the input state from a window event
+    ///
+    /// Key and mouse button statuses are kept up to date from the press and
+    /// release events, rather than by asking the window system about every
+    /// key each frame. Inputs the game uses are also added, timestamped, to
+    /// this frame's input events.
     ///
-    /// This should be called once per frame
+    /// @param event    Event polled from the game window
     ///////////////////////////////////////////////////////////////////////////
-    void updateKeyStatuses();
+    void handleEvent(const sf::Event& event);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Sets the pressed status for all keys to false
+    /// @brief Updates the input state from an input event
+    ///
+    /// This is how window events are applied, and lets recorded input be
+    /// played back exactly as it was first received.
+    ///
+    /// @param event    The input, which is added to this frame's input events
+    ///                 as is
+    ///////////////////////////////////////////////////////////////////////////
+    void handleInputEvent(const InputEvent& event);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the inputs received this frame, in the order received
+    ///
+    /// @return This frame's input events
+    ///////////////////////////////////////////////////////////////////////////
+    const std::vector<InputEvent>& getInputEvents() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Clears everything which only lasts for a frame
+    ///
+    /// This clears the pressed (this frame) statuses, clicks, scroll delta
+    /// and input events, and should be called after each simulation step, so
+    /// that input received while no step runs waits for the next one.
+    ///////////////////////////////////////////////////////////////////////////
+    void clearFrameInput();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Sets the pressed status for all keys and buttons to false
     ///////////////////////////////////////////////////////////////////////////
     void clearAllKeyStatuses();
 
@@ -107,7 +180,7 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Sets whether or not a key was pressed this frame
     ///
-    /// @param sfKey    Key value to search for in the mappings and set
+    /// @param sfKey    Key value to look up in the mappings and set
     /// @param status   Whether or not the key was pressed
     ///////////////////////////////////////////////////////////////////////////
     void setKeyPressedStatus(sf::Keyboard::Key sfKey, bool status);
@@ -144,8 +217,21 @@ public:
     sf::Font font;
     sf::Vector2u frameSize;
     sf::Vector2f frameScale;
-    sf::RenderWindow gameWindow;
-    sf::RenderTexture frameBuffer;
+    std::unique_ptr<sf::RenderWindow> gameWindow;
+    std::unique_ptr<sf::RenderTexture> frameBuffer;
+    FrameCompositor frameCompositor;
+    RenderStats renderStats;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Whether the game runs without a window
+    ///
+    /// There is then no GL context, so the window and frame buffer are left
+    /// null and nothing may be drawn, not even a font's glyphs, as that
+    /// creates textures. Even constructing a window or texture would open
+    /// the display, for the context SFML shares between them. Only the game
+    /// state is kept up to date.
+    ///////////////////////////////////////////////////////////////////////////
+    bool headless = false;
 
     ///////////////////////////////////////////////////////////////////////////
     /// Input
@@ -163,10 +249,27 @@ public:
     /// Managers
     ///////////////////////////////////////////////////////////////////////////
 
+    Profiler profiler;
+    JobSystem jobSystem;
     std::unique_ptr<ZoneManager> zoneManager;
     std::unique_ptr<DebugManager> debugManager;
     std::unique_ptr<WindowManager> windowManager;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// Game
+    ///////////////////////////////////////////////////////////////////////////
+
+    Random random;
+    MessageLog messageLog;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Whether the session must play out the same again given the
+    ///        same seed and input
+    ///
+    /// Nothing which affects the game may then depend on wall-clock time.
+    ///////////////////////////////////////////////////////////////////////////
+    bool deterministic = false;
+
 private:
 
     ///////////////////////////////////////////////////////////////////////////
@@ -181,9 +284,27 @@ private:
     ///////////////////////////////////////////////////////////////////////////
     void draw(sf::RenderTarget& target, sf::RenderStates) const override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the Key an sf::Keyboard::Key is bound to
+    ///
+    /// @param sfKey    Key value to look up
+    ///
+    /// @return The bound Key, or Key::Count if it is not bound
+    ///////////////////////////////////////////////////////////////////////////
+    Key getKey(sf::Keyboard::Key sfKey) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Rebuilds the reverse mapping from sf::Keyboard::Keys to Keys
+    ///////////////////////////////////////////////////////////////////////////
+    void updateKeyLookup();
+
     std::array<bool, static_cast<int>(Key::Count)> m_keyStatuses;
     std::array<bool, static_cast<int>(Key::Count)> m_keyPressedStatuses;
     std::array<sf::Keyboard::Key, static_cast<int>(Key::Count)> m_keyMappings;
+    std::array<Key, sf::Keyboard::KeyCount> m_keyLookup;
+    std::array<bool, static_cast<int>(MouseButton::Count)> m_mouseStatuses;
+    std::vector<InputEvent> m_inputEvents;
+    sf::Clock m_inputClock;
 };
 
 #endif
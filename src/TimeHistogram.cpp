@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   TimeHistogram.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Histogram of durations over rolling windows, for percentiles
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TimeHistogram.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+TimeHistogram::TimeHistogram(sf::Uint32 windows)
+    : m_counts(static_cast<std::size_t>(windows) * BucketCount),
+      m_windows(windows)
+{
+    if (!windows) {
+        log_exit("Time histograms need a window");
+    }
+
+    clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TimeHistogram::add(sf::Time time)
+{
+    auto microseconds = std::max(time.asMicroseconds(), sf::Int64(0));
+    auto& window = m_windows[m_current];
+
+    ++m_counts[m_current * BucketCount +
+               getBucket(static_cast<sf::Uint64>(microseconds))];
+    ++window.count;
+    window.sum += microseconds;
+    window.maximum = std::max(window.maximum, microseconds);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TimeHistogram::advance()
+{
+    m_current = (m_current + 1) % static_cast<sf::Uint32>(m_windows.size());
+
+    auto counts = m_counts.begin() + m_current * BucketCount;
+    std::fill(counts, counts + BucketCount, 0);
+    m_windows[m_current] = {0, 0, 0};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TimeHistogram::clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    std::fill(m_windows.begin(), m_windows.end(), Window{0, 0, 0});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 TimeHistogram::getCount() const
+{
+    sf::Uint64 count = 0;
+    for (const auto& window : m_windows) {
+        count += window.count;
+    }
+
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Time TimeHistogram::getMean() const
+{
+    sf::Uint64 count = 0;
+    sf::Int64 sum = 0;
+    for (const auto& window : m_windows) {
+        count += window.count;
+        sum += window.sum;
+    }
+
+    if (!count) {
+        return sf::Time::Zero;
+    }
+
+    return sf::microseconds(sum / static_cast<sf::Int64>(count));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Time TimeHistogram::getMaximum() const
+{
+    sf::Int64 maximum = 0;
+    for (const auto& window : m_windows) {
+        maximum = std::max(maximum, window.maximum);
+    }
+
+    return sf::microseconds(maximum);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Time TimeHistogram::getPercentile(float percentile) const
+{
+    auto count = getCount();
+    if (!count) {
+        return sf::Time::Zero;
+    }
+
+    // The rank of the duration at the percentile, counting from 1
+    auto fraction = std::min(std::max(percentile, 0.f), 100.f) / 100.f;
+    auto rank = std::max(static_cast<sf::Uint64>(std::ceil(
+        static_cast<double>(fraction) * static_cast<double>(count))),
+        sf::Uint64(1));
+
+    auto maximum = static_cast<sf::Uint64>(getMaximum().asMicroseconds());
+    sf::Uint64 seen = 0;
+
+    for (sf::Uint32 bucket = 0; bucket < BucketCount; ++bucket) {
+        for (std::size_t i = 0; i < m_windows.size(); ++i) {
+            seen += m_counts[i * BucketCount + bucket];
+        }
+
+        if (seen >= rank) {
+            return sf::microseconds(static_cast<sf::Int64>(
+                std::min(getBucketEnd(bucket), maximum)));
+        }
+    }
+
+    return getMaximum();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 TimeHistogram::getBucket(sf::Uint64 microseconds)
+{
+    if (microseconds < SubBuckets) {
+        return static_cast<sf::Uint32>(microseconds);
+    }
+
+    // Each further power of two is split into the upper half of the
+    // sub-buckets, as its values all have the top bit set
+    auto limit = (sf::Uint64(1) << (MaxShift + SubBucketBits)) - 1;
+    microseconds = std::min(microseconds, limit);
+
+    sf::Uint32 shift = 1;
+    while ((microseconds >> shift) >= SubBuckets) {
+        ++shift;
+    }
+
+    return static_cast<sf::Uint32>(SubBuckets + (shift - 1) * SubBuckets / 2 +
+                                   (microseconds >> shift) - SubBuckets / 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 TimeHistogram::getBucketEnd(sf::Uint32 bucket)
+{
+    if (bucket < SubBuckets) {
+        return bucket;
+    }
+
+    auto index = bucket - SubBuckets;
+    auto shift = index / (SubBuckets / 2) + 1;
+    auto sub = index % (SubBuckets / 2) + SubBuckets / 2;
+
+    return ((sub + 1) << shift) - 1;
+}
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   TimeHistogram.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Histogram of durations over rolling windows, for percentiles
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__TIME_HISTOGRAM_HPP
+#define ROGUELIKE__TIME_HISTOGRAM_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Histogram of durations over rolling windows, for percentiles
+///
+/// Durations are counted in microsecond buckets which grow with the
+/// duration, as in an HDR histogram: every power of two is split into the
+/// same number of buckets, so durations from a microsecond to over an hour
+/// are all counted to within 1/64 of their length. Adding a duration is
+/// O(1), and the histogram never allocates after construction.
+///
+/// Durations are added to the current window, and advance() starts a new
+/// window in place of the oldest, so statistics always cover the last few
+/// windows, however long the histogram has been running.
+///////////////////////////////////////////////////////////////////////////////
+class TimeHistogram {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of buckets below the first power of two that is split
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 SubBucketBits = 7;
+    static constexpr sf::Uint64 SubBuckets = 1 << SubBucketBits;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of powers of two split into buckets
+    ///
+    /// Longer durations are counted as the longest one, of 2^32 - 1 us.
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 MaxShift = 32 - SubBucketBits;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of buckets in each window
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 BucketCount =
+        SubBuckets + MaxShift * SubBuckets / 2;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Constructor
+    ///
+    /// @param windows  Number of windows the statistics cover
+    ///////////////////////////////////////////////////////////////////////////
+    explicit TimeHistogram(sf::Uint32 windows = 1);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a duration to the current window
+    ///
+    /// @param time The duration, negative ones counting as 0
+    ///////////////////////////////////////////////////////////////////////////
+    void add(sf::Time time);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Starts a new window, forgetting the oldest
+    ///////////////////////////////////////////////////////////////////////////
+    void advance();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Empties every window
+    ///////////////////////////////////////////////////////////////////////////
+    void clear();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of durations in the windows
+    ///
+    /// @return Number of durations
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint64 getCount() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the mean of the durations in the windows
+    ///
+    /// @return Exact mean, or 0 if there are no durations
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Time getMean() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the longest duration in the windows
+    ///
+    /// @return Exact maximum, or 0 if there are no durations
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Time getMaximum() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the duration which a percentage of durations are under
+    ///
+    /// @param percentile   Percentage of durations, from 0 to 100
+    ///
+    /// @return The longest duration in the percentile's bucket, which is
+    ///         never over the maximum, or 0 if there are no durations
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Time getPercentile(float percentile) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Totals of a window
+    ///////////////////////////////////////////////////////////////////////////
+    struct Window {
+        sf::Uint64 count;
+        sf::Int64 sum;
+        sf::Int64 maximum;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the bucket a duration is counted in
+    ///
+    /// @param microseconds The duration
+    ///
+    /// @return Index of the bucket
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint32 getBucket(sf::Uint64 microseconds);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the longest duration counted in a bucket
+    ///
+    /// @param bucket   Index of the bucket
+    ///
+    /// @return The duration in microseconds
+    ///////////////////////////////////////////////////////////////////////////
+    static sf::Uint64 getBucketEnd(sf::Uint32 bucket);
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<sf::Uint32> m_counts;
+    std::vector<Window> m_windows;
+    sf::Uint32 m_current = 0;
+};
+
+#endif
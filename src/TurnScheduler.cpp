@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   TurnScheduler.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Priority queue deciding which entity acts next in turn-based time
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TurnScheduler.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+TurnScheduler::TurnScheduler()
+    : m_buckets(BucketCount), m_occupied(BucketCount / 64, 0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TurnScheduler::reserve(std::size_t count)
+{
+    if (m_nodes.size() < count) {
+        m_nodes.resize(count);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TurnScheduler::schedule(Entity entity, Time delay)
+{
+    if (delay > MaxDelay) {
+        log_exit("Delay is too long: " + std::to_string(delay));
+    }
+
+    if (isScheduled(entity)) {
+        unlink(entity.index);
+    }
+    else if (entity.index >= m_nodes.size()) {
+        m_nodes.resize(entity.index + 1);
+    }
+    else if (m_nodes[entity.index].scheduled) {
+        // A stale handle to a destroyed entity whose index was reused
+        log_exit("Index is scheduled for another entity: " +
+                 std::to_string(entity.index));
+    }
+
+    auto& node = m_nodes[entity.index];
+    node.entity = entity;
+    node.time = m_time + delay;
+    link(entity.index);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TurnScheduler::unschedule(Entity entity)
+{
+    if (!isScheduled(entity)) {
+        log_warn("Entity is not scheduled: " + std::to_string(entity.index));
+        return;
+    }
+
+    unlink(entity.index);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool TurnScheduler::isScheduled(Entity entity) const
+{
+    return entity.index < m_nodes.size() &&
+           m_nodes[entity.index].scheduled &&
+           m_nodes[entity.index].entity == entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+TurnScheduler::Time TurnScheduler::getScheduledTime(Entity entity) const
+{
+    if (!isScheduled(entity)) {
+        log_exit("Entity is not scheduled: " + std::to_string(entity.index));
+    }
+
+    return m_nodes[entity.index].time;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Entity TurnScheduler::peek() const
+{
+    if (!m_size) {
+        log_exit("No entity is scheduled");
+    }
+
+    return m_nodes[m_buckets[findFirstBucket()].head].entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Entity TurnScheduler::next()
+{
+    auto entity = peek();
+
+    m_time = m_nodes[entity.index].time;
+    unlink(entity.index);
+
+    return entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+TurnScheduler::Time TurnScheduler::getTime() const
+{
+    return m_time;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t TurnScheduler::size() const
+{
+    return m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool TurnScheduler::empty() const
+{
+    return m_size == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TurnScheduler::link(sf::Uint32 index)
+{
+    auto& node = m_nodes[index];
+    auto bucketIndex = static_cast<sf::Uint32>(node.time % BucketCount);
+    auto& bucket = m_buckets[bucketIndex];
+
+    node.next = None;
+    node.prev = bucket.tail;
+    node.scheduled = true;
+
+    if (bucket.tail != None) {
+        m_nodes[bucket.tail].next = index;
+    }
+    else {
+        bucket.head = index;
+        m_occupied[bucketIndex / 64] |= sf::Uint64(1) << (bucketIndex % 64);
+    }
+    bucket.tail = index;
+
+    ++m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void TurnScheduler::unlink(sf::Uint32 index)
+{
+    auto& node = m_nodes[index];
+    auto bucketIndex = static_cast<sf::Uint32>(node.time % BucketCount);
+    auto& bucket = m_buckets[bucketIndex];
+
+    if (node.prev != None) {
+        m_nodes[node.prev].next = node.next;
+    }
+    else {
+        bucket.head = node.next;
+    }
+
+    if (node.next != None) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    else {
+        bucket.tail = node.prev;
+    }
+
+    if (bucket.head == None) {
+        m_occupied[bucketIndex / 64] &=
+            ~(sf::Uint64(1) << (bucketIndex % 64));
+    }
+
+    node.scheduled = false;
+    --m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint32 TurnScheduler::findFirstBucket() const
+{
+    // Every scheduled time is within MaxDelay of the current time, so the
+    // first occupied bucket in ring order from the current time is earliest
+    auto words = static_cast<sf::Uint32>(m_occupied.size());
+    auto start = static_cast<sf::Uint32>(m_time % BucketCount);
+    auto word = start / 64;
+    auto bits = m_occupied[word] & (~sf::Uint64(0) << (start % 64));
+
+    // The last pass wraps back around to the start of the first word
+    for (sf::Uint32 i = 0; !bits && i < words; ++i) {
+        word = (word + 1) % words;
+        bits = m_occupied[word];
+    }
+
+    if (!bits) {
+        log_exit("Scheduler bitmap is inconsistent");
+    }
+
+    sf::Uint32 bit = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++bit;
+    }
+
+    return (word * 64) + bit;
+}
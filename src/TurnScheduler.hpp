@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   TurnScheduler.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Priority queue deciding which entity acts next in turn-based time
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__TURN_SCHEDULER_HPP
+#define ROGUELIKE__TURN_SCHEDULER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+
+#include "Common.hpp"
+#include "EntityStore.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Priority queue deciding which entity acts next in turn-based time
+///
+/// Each scheduled entity has the game time at which it next acts. As an
+/// entity is never scheduled more than MaxDelay ticks ahead, entities are
+/// kept in a ring of one bucket per tick (a calendar queue), so scheduling,
+/// rescheduling and unscheduling are all O(1). Each bucket is an intrusive
+/// list, so entities acting on the same tick act in the order they were
+/// scheduled, and a bitmap of non-empty buckets finds the next turn quickly
+/// even when entities are few and far apart. Once reserve() has been called
+/// with the number of entity indices, no operation allocates.
+///////////////////////////////////////////////////////////////////////////////
+class TurnScheduler {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Game time, measured in ticks
+    ///////////////////////////////////////////////////////////////////////////
+    typedef sf::Uint64 Time;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of ticks a normal speed action takes
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr Time TurnLength = 100;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Maximum number of ticks an entity can be scheduled ahead
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr Time MaxDelay = (1 << 14) - 1;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates an empty TurnScheduler
+    ///////////////////////////////////////////////////////////////////////////
+    TurnScheduler();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    TurnScheduler(const TurnScheduler&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const TurnScheduler&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Reserves space to avoid later reallocation
+    ///
+    /// @param count    Number of entity indices expected to be scheduled
+    ///////////////////////////////////////////////////////////////////////////
+    void reserve(std::size_t count);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Schedules an entity to act after a delay
+    ///
+    /// If the entity is already scheduled it is moved to the new time, which
+    /// may be earlier or later than its previous time.
+    ///
+    /// @param entity   Handle of the entity
+    /// @param delay    Ticks from the current time until the entity acts, at
+    ///                 most MaxDelay
+    ///////////////////////////////////////////////////////////////////////////
+    void schedule(Entity entity, Time delay);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes an entity from the schedule
+    ///
+    /// @param entity   Handle of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    void unschedule(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not an entity is scheduled
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return True if the entity is scheduled, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool isScheduled(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the time at which a scheduled entity acts
+    ///
+    /// @param entity   Handle of the entity
+    ///
+    /// @return Time at which the entity acts
+    ///////////////////////////////////////////////////////////////////////////
+    Time getScheduledTime(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the entity that acts next without removing it
+    ///
+    /// @return Handle of the entity that acts next
+    ///////////////////////////////////////////////////////////////////////////
+    Entity peek() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes the entity that acts next and advances the current time
+    ///        to its turn
+    ///
+    /// The entity should be scheduled again once it has acted.
+    ///
+    /// @return Handle of the entity whose turn it is
+    ///////////////////////////////////////////////////////////////////////////
+    Entity next();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the current time
+    ///
+    /// @return The time of the most recent turn
+    ///////////////////////////////////////////////////////////////////////////
+    Time getTime() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of scheduled entities
+    ///
+    /// @return The number of scheduled entities
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t size() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not any entity is scheduled
+    ///
+    /// @return True if no entity is scheduled, false otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool empty() const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks the end of a list / an entity index that is not scheduled
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 None = 0xFFFFFFFF;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of buckets in the ring, one per tick
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 BucketCount = MaxDelay + 1;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Scheduled turn of an entity and its links in its bucket's list
+    ///////////////////////////////////////////////////////////////////////////
+    struct Node {
+        Entity entity = {None, 0};
+        Time time = 0;
+        sf::Uint32 next = None;
+        sf::Uint32 prev = None;
+        bool scheduled = false;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A list of the entities acting on one tick (modulo BucketCount)
+    ///////////////////////////////////////////////////////////////////////////
+    struct Bucket {
+        sf::Uint32 head = None;
+        sf::Uint32 tail = None;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends a node to the bucket of its time
+    ///
+    /// @param index    Entity index of the node
+    ///////////////////////////////////////////////////////////////////////////
+    void link(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a node from its bucket
+    ///
+    /// @param index    Entity index of the node
+    ///////////////////////////////////////////////////////////////////////////
+    void unlink(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the first non-empty bucket at or after the current time
+    ///
+    /// @return Index of the bucket
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 findFirstBucket() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    Time m_time = 0;
+    std::size_t m_size = 0;
+    std::vector<Node> m_nodes;
+    std::vector<Bucket> m_buckets;
+    std::vector<sf::Uint64> m_occupied;
+};
+
+#endif
@@ -15,7 +15,25 @@
 ///////////////////////////////////////////////////////////////////////////////
 /// Static variables
 ///////////////////////////////////////////////////////////////////////////////
-std::string Window::focus = "";
+WindowId Window::focus;
 
 ///////////////////////////////////////////////////////////////////////////////
 Window::Window(const std::string& tag) : tag(tag) {}
+
+///////////////////////////////////////////////////////////////////////////////
+WindowId Window::getId() const
+{
+    return m_id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::Uint64 Window::getContentVersion() const
+{
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool Window::appendVertices(RenderBatch&) const
+{
+    return false;
+}
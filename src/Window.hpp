@@ -12,6 +12,31 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Common.hpp"
+#include "RenderBatch.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Stable handle to a Window open in the WindowManager
+///
+/// A default constructed WindowId refers to no Window. The slot of a closed
+/// Window is reused, but with a new generation, so stale handles never refer
+/// to a different Window.
+///////////////////////////////////////////////////////////////////////////////
+struct WindowId {
+    sf::Uint32 index = 0xFFFFFFFF;
+    sf::Uint32 generation = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+inline bool operator==(const WindowId& left, const WindowId& right)
+{
+    return left.index == right.index && left.generation == right.generation;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline bool operator!=(const WindowId& left, const WindowId& right)
+{
+    return !(left == right);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Highest parent class for all GUI elements
@@ -43,11 +68,63 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     virtual void update() = 0;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the rectangle the window covers in frame-space
+    ///
+    /// The WindowManager uses this to find the windows which might contain a
+    /// position before asking them with containsPosition().
+    ///
+    /// @return Bounds of the window in frame-space
+    ///////////////////////////////////////////////////////////////////////////
+    virtual sf::FloatRect getBounds() const = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number which changes whenever the window's content
+    ///        does
+    ///
+    /// The WindowManager keeps the rendered content of windows that return a
+    /// non-zero version in a cached layer, and only redraws it into the layer
+    /// when the version changes, so moving such a window costs one textured
+    /// quad. Windows returning 0 (the default) are drawn directly each frame.
+    ///
+    /// @return Version of the window's content, or 0 to disable caching
+    ///////////////////////////////////////////////////////////////////////////
+    virtual sf::Uint64 getContentVersion() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends the window's geometry to a batch instead of drawing it
+    ///
+    /// Windows which can describe their content as transformed quads should
+    /// override this, so that the WindowManager can draw them along with
+    /// other windows using the same texture in a single draw call. By
+    /// default this appends nothing and returns false, and the window is
+    /// drawn with draw().
+    ///
+    /// @param batch    Batch to append the window's quads to
+    ///
+    /// @return True if the window was appended, false if it must be drawn
+    ///////////////////////////////////////////////////////////////////////////
+    virtual bool appendVertices(RenderBatch& batch) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the handle the WindowManager assigned to the window
+    ///
+    /// @return Handle of the window, or WindowId() if it has not been added
+    ///////////////////////////////////////////////////////////////////////////
+    WindowId getId() const;
+
     ///////////////////////////////////////////////////////////////////////////
     const std::string tag;
     bool shouldClose = false;
-    static std::string focus;
+    static WindowId focus;
     bool consumeMouse = false;
+
+private:
+
+    friend class WindowManager;
+
+    ///////////////////////////////////////////////////////////////////////////
+    WindowId m_id;
 };
 
 #endif
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   WindowIndex.cpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Uniform grid of Window bounds for finding the topmost Window under
+///         a point
+///////////////////////////////////////////////////////////////////////////////
+
+#include "WindowIndex.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include "Common.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::create(const sf::Vector2u& frameSize)
+{
+    m_frameSize = frameSize;
+    m_gridSize = {std::max((frameSize.x + CellSize - 1) / CellSize, 1u),
+                  std::max((frameSize.y + CellSize - 1) / CellSize, 1u)};
+    m_cells.assign(m_gridSize.x * m_gridSize.y, {});
+    m_records.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const sf::Vector2u& WindowIndex::getFrameSize() const
+{
+    return m_frameSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::insert(const Window* window, const sf::FloatRect& bounds,
+                         sf::Uint64 z)
+{
+    auto index = window->getId().index;
+
+    if (index >= m_records.size()) {
+        m_records.resize(index + 1);
+    }
+    else if (m_records[index].indexed) {
+        log_exit("Window is already indexed: " + window->tag);
+    }
+
+    auto& record = m_records[index];
+    record = {bounds, getCells(bounds), z, true};
+    addToCells(window, record);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::remove(const Window* window)
+{
+    auto index = window->getId().index;
+
+    if (index >= m_records.size() || !m_records[index].indexed) {
+        log_warn("Window is not indexed: " + window->tag);
+        return;
+    }
+
+    removeFromCells(window, m_records[index]);
+    m_records[index].indexed = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::setBounds(const Window* window, const sf::FloatRect& bounds)
+{
+    auto& record = getRecord(window);
+    if (record.bounds == bounds) {
+        return;
+    }
+    record.bounds = bounds;
+
+    // Most moves stay within the same cells
+    auto cells = getCells(bounds);
+    if (cells != record.cells) {
+        removeFromCells(window, record);
+        record.cells = cells;
+        addToCells(window, record);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::setZ(const Window* window, sf::Uint64 z)
+{
+    auto& record = getRecord(window);
+    record.z = z;
+
+    for (auto y = record.cells.top;
+         y < record.cells.top + record.cells.height; ++y) {
+        for (auto x = record.cells.left;
+             x < record.cells.left + record.cells.width; ++x) {
+            auto& cell = m_cells[static_cast<sf::Uint32>(y) * m_gridSize.x +
+                                 static_cast<sf::Uint32>(x)];
+            for (auto& entry : cell) {
+                if (entry.window == window) {
+                    entry.z = z;
+                }
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Window* WindowIndex::getTopmostAt(const sf::Vector2i& position) const
+{
+    if (m_cells.empty()) {
+        return nullptr;
+    }
+
+    auto x = std::min(static_cast<sf::Uint32>(std::max(position.x, 0)) /
+                      CellSize, m_gridSize.x - 1);
+    auto y = std::min(static_cast<sf::Uint32>(std::max(position.y, 0)) /
+                      CellSize, m_gridSize.y - 1);
+
+    const Window* topmost = nullptr;
+    sf::Uint64 topmostZ = 0;
+    sf::Vector2f point(position);
+
+    for (const auto& entry : m_cells[(y * m_gridSize.x) + x]) {
+        if ((!topmost || entry.z > topmostZ) &&
+            m_records[entry.window->getId().index].bounds.contains(point) &&
+            entry.window->containsPosition(position)) {
+            topmost = entry.window;
+            topmostZ = entry.z;
+        }
+    }
+
+    return topmost;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+sf::IntRect WindowIndex::getCells(const sf::FloatRect& bounds) const
+{
+    auto cell = static_cast<float>(CellSize);
+    auto clampX = [this](float x) {
+        return std::min(std::max(static_cast<int>(x), 0),
+                        static_cast<int>(m_gridSize.x) - 1);
+    };
+    auto clampY = [this](float y) {
+        return std::min(std::max(static_cast<int>(y), 0),
+                        static_cast<int>(m_gridSize.y) - 1);
+    };
+
+    auto left = clampX(std::floor(bounds.left / cell));
+    auto top = clampY(std::floor(bounds.top / cell));
+    auto right = clampX(std::floor((bounds.left + bounds.width) / cell));
+    auto bottom = clampY(std::floor((bounds.top + bounds.height) / cell));
+
+    return {left, top, right - left + 1, bottom - top + 1};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+WindowIndex::Record& WindowIndex::getRecord(const Window* window)
+{
+    auto index = window->getId().index;
+
+    if (index >= m_records.size() || !m_records[index].indexed) {
+        log_exit("Window is not indexed: " + window->tag);
+    }
+
+    return m_records[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::addToCells(const Window* window, const Record& record)
+{
+    for (auto y = record.cells.top;
+         y < record.cells.top + record.cells.height; ++y) {
+        for (auto x = record.cells.left;
+             x < record.cells.left + record.cells.width; ++x) {
+            m_cells[static_cast<sf::Uint32>(y) * m_gridSize.x +
+                    static_cast<sf::Uint32>(x)].push_back({window, record.z});
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowIndex::removeFromCells(const Window* window, const Record& record)
+{
+    for (auto y = record.cells.top;
+         y < record.cells.top + record.cells.height; ++y) {
+        for (auto x = record.cells.left;
+             x < record.cells.left + record.cells.width; ++x) {
+            auto& cell = m_cells[static_cast<sf::Uint32>(y) * m_gridSize.x +
+                                 static_cast<sf::Uint32>(x)];
+            for (std::size_t i = 0; i < cell.size(); ++i) {
+                if (cell[i].window == window) {
+                    cell[i] = cell.back();
+                    cell.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
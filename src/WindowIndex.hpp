@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file   WindowIndex.hpp
+/// @author Jacob Adkins (jpadkins)
+/// @brief  Uniform grid of Window bounds for finding the topmost Window under
+///         a point
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROGUELIKE__WINDOW_INDEX_HPP
+#define ROGUELIKE__WINDOW_INDEX_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+/// Headers
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+#include "Window.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Uniform grid of Window bounds for finding the topmost Window under
+///        a point
+///
+/// The frame is divided into square cells, and each Window is listed in every
+/// cell its bounds overlap along with its z-level. Finding the Window under a
+/// point only has to look through the few Windows listed in a single cell,
+/// however many Windows are open. Bounds outside of the frame are clamped to
+/// the cells along its edges. Windows are identified by the index of their
+/// WindowId, so they must have been added to the WindowManager.
+///////////////////////////////////////////////////////////////////////////////
+class WindowIndex {
+public:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Width and height of a cell in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 CellSize = 64;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Default constructor, create() must be called before use
+    ///////////////////////////////////////////////////////////////////////////
+    WindowIndex() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable copy constructor
+    ///////////////////////////////////////////////////////////////////////////
+    WindowIndex(const WindowIndex&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Disable assignment operator
+    ///////////////////////////////////////////////////////////////////////////
+    void operator=(const WindowIndex&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief (Re)creates an empty WindowIndex
+    ///
+    /// @param frameSize    Size of the frame in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    void create(const sf::Vector2u& frameSize);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the frame size the WindowIndex was created with
+    ///
+    /// @return Size of the frame in pixels
+    ///////////////////////////////////////////////////////////////////////////
+    const sf::Vector2u& getFrameSize() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Adds a Window
+    ///
+    /// @param window   The Window to add
+    /// @param bounds   Bounds of the Window in frame-space
+    /// @param z        Z-level of the Window, higher is on top
+    ///////////////////////////////////////////////////////////////////////////
+    void insert(const Window* window, const sf::FloatRect& bounds,
+                sf::Uint64 z);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a Window
+    ///
+    /// @param window   The Window to remove
+    ///////////////////////////////////////////////////////////////////////////
+    void remove(const Window* window);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Updates the bounds of a Window, e.g. after it has been moved
+    ///
+    /// This does nothing if the bounds have not changed.
+    ///
+    /// @param window   The Window to update
+    /// @param bounds   New bounds of the Window in frame-space
+    ///////////////////////////////////////////////////////////////////////////
+    void setBounds(const Window* window, const sf::FloatRect& bounds);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Updates the z-level of a Window
+    ///
+    /// @param window   The Window to update
+    /// @param z        New z-level of the Window, higher is on top
+    ///////////////////////////////////////////////////////////////////////////
+    void setZ(const Window* window, sf::Uint64 z);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the topmost Window containing a position
+    ///
+    /// Windows whose bounds contain the position are asked whether they
+    /// actually contain it with Window::containsPosition().
+    ///
+    /// @param position Position in frame-space
+    ///
+    /// @return The topmost Window containing the position, or nullptr
+    ///////////////////////////////////////////////////////////////////////////
+    const Window* getTopmostAt(const sf::Vector2i& position) const;
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief A Window listed in a cell
+    ///////////////////////////////////////////////////////////////////////////
+    struct Entry {
+        const Window* window;
+        sf::Uint64 z;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Bounds and z-level of an indexed Window
+    ///////////////////////////////////////////////////////////////////////////
+    struct Record {
+        sf::FloatRect bounds;
+        sf::IntRect cells;
+        sf::Uint64 z = 0;
+        bool indexed = false;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the range of cells overlapped by a rectangle
+    ///
+    /// @param bounds   Rectangle in frame-space
+    ///
+    /// @return Range of cells, clamped to the grid
+    ///////////////////////////////////////////////////////////////////////////
+    sf::IntRect getCells(const sf::FloatRect& bounds) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the record of an indexed Window
+    ///
+    /// @param window   The Window
+    ///
+    /// @return Record of the Window
+    ///////////////////////////////////////////////////////////////////////////
+    Record& getRecord(const Window* window);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Lists a Window in a range of cells
+    ///
+    /// @param window   The Window
+    /// @param record   Cells and z-level of the Window
+    ///////////////////////////////////////////////////////////////////////////
+    void addToCells(const Window* window, const Record& record);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes a Window from a range of cells
+    ///
+    /// @param window   The Window
+    /// @param record   Cells of the Window
+    ///////////////////////////////////////////////////////////////////////////
+    void removeFromCells(const Window* window, const Record& record);
+
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Vector2u m_frameSize;
+    sf::Vector2u m_gridSize;
+    std::vector<std::vector<Entry>> m_cells;
+    std::vector<Record> m_records;
+};
+
+#endif
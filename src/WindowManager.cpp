@@ -10,30 +10,48 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <memory>
+#include <cmath>
+
+#include "State.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 void WindowManager::remove(const std::string& tag)
 {
-    auto it = getWindowIter(tag);
+    auto id = find(tag);
 
-    if (it != m_windows.end()) {
-        m_windows.erase(it);
+    if (id != WindowId()) {
+        remove(id);
     }
     else {
         log_warn("Window is not open: " + tag);
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::remove(WindowId id)
+{
+    auto window = getWindow(id);
+
+    if (!window) {
+        log_warn("Window is not open: " + std::to_string(id.index));
+        return;
+    }
+
+    // Stop drawing and hit-testing the window now, but leave it in its slot
+    // until the end of update() in case it is being updated
+    m_slots[id.index].removing = true;
+    m_index.remove(window);
+    State::get().frameCompositor.addDamage(m_slots[id.index].bounds);
+    m_removals.push_back(id);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void WindowManager::setHighest(const std::string& tag)
 {
-    auto it = getWindowIter(tag);
+    auto id = find(tag);
 
-    if (it != m_windows.end()) {
-        auto tempPtr = std::move(*it);
-        m_windows.erase(it);
-        m_windows.emplace_back(std::move(tempPtr));
+    if (id != WindowId()) {
+        setHighest(id);
     }
     else {
         log_warn("Window is not open: " + tag);
@@ -41,62 +59,333 @@ void WindowManager::setHighest(const std::string& tag)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void WindowManager::addWindow(Window* window)
+void WindowManager::setHighest(WindowId id)
+{
+    auto window = getWindow(id);
+
+    if (!window) {
+        log_warn("Window is not open: " + std::to_string(id.index));
+        return;
+    }
+
+    if (m_top != id.index) {
+        unlink(id.index);
+        linkTop(id.index);
+        State::get().frameCompositor.addDamage(m_slots[id.index].bounds);
+    }
+    m_index.setZ(window, ++m_nextZ);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+WindowId WindowManager::addWindow(Window* window)
 {
     if (!window) {
         log_exit("Null argument");
     }
 
-    m_windows.emplace_back(std::unique_ptr<Window>(window));
+    if (m_index.getFrameSize() != State::get().frameSize) {
+        rebuildIndex();
+    }
+
+    sf::Uint32 index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<sf::Uint32>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    auto& slot = m_slots[index];
+    slot.window.reset(window);
+    slot.removing = false;
+    slot.bounds = window->getBounds();
+    window->m_id = {index, slot.generation};
+    linkTop(index);
+
+    auto it = m_tags.find(window->tag);
+    if (it != m_tags.end()) {
+        log_warn("Window tag is already in use: " + window->tag);
+        it->second = window->m_id;
+    }
+    else {
+        m_tags.insert({window->tag, window->m_id});
+    }
+
+    m_index.insert(window, slot.bounds, ++m_nextZ);
+    State::get().frameCompositor.addDamage(slot.bounds);
+
+    return window->m_id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+WindowId WindowManager::find(const std::string& tag) const
+{
+    auto it = m_tags.find(tag);
+    return it != m_tags.end() ? it->second : WindowId();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Window* WindowManager::getWindow(WindowId id) const
+{
+    if (id.index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    const auto& slot = m_slots[id.index];
+    return slot.generation == id.generation && !slot.removing
+        ? slot.window.get() : nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void WindowManager::update()
 {
-    bool mouseConsumed = false;
-    auto it = m_windows.rbegin();
+    if (m_index.getFrameSize() != State::get().frameSize) {
+        rebuildIndex();
+    }
 
-    while (it != m_windows.rend()) {
+    auto target = getMouseTarget();
 
-        // Update window
-        if (!mouseConsumed &&
-            ((*it)->containsMouse() || Window::focus == (*it)->tag)) {
+    // Windows may be raised while updating, so the order is fixed up front
+    m_updateOrder.clear();
+    for (auto index = m_top; index != None; index = m_slots[index].below) {
+        if (!m_slots[index].removing) {
+            m_updateOrder.push_back(m_slots[index].window.get());
+        }
+    }
 
-            (*it)->consumeMouse = true;
-            mouseConsumed = true;
+    for (auto window : m_updateOrder) {
+        if (m_slots[window->m_id.index].removing) {
+            continue;
         }
-        else {
-            (*it)->consumeMouse = false;
+
+        window->consumeMouse = window == target;
+        window->update();
+
+        // Remove if need be, otherwise keep up with any movement
+        if (window->shouldClose) {
+            remove(window->m_id);
+            continue;
         }
 
-        (*it)->update();
+        auto& slot = m_slots[window->m_id.index];
+        auto bounds = window->getBounds();
+        auto version = window->getContentVersion();
 
-        // Remove if need be
-        if ((*it)->shouldClose) {
-            auto tmpIt = it;
-            std::advance(tmpIt, 1);
-            m_windows.erase(tmpIt.base());
+        // Windows without a content version may have changed at any time
+        if (bounds != slot.bounds || !version ||
+            version != slot.layerVersion) {
+            State::get().frameCompositor.addDamage(slot.bounds);
+            State::get().frameCompositor.addDamage(bounds);
+            slot.bounds = bounds;
         }
+        m_index.setBounds(window, bounds);
+    }
+
+    processRemovals();
 
-        ++it;
+    if (!State::get().headless) {
+        updateLayers();
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void WindowManager::draw(sf::RenderTarget& target, sf::RenderStates) const
 {
-    for (auto& frame : m_windows) {
-        target.draw(*frame);
+    m_batch.begin(target);
+
+    for (auto index = m_bottom; index != None; index = m_slots[index].above) {
+        const auto& slot = m_slots[index];
+        if (slot.removing) {
+            continue;
+        }
+
+        // Windows added or changed since update() are drawn directly
+        if (slot.layer.page != LayerAtlas::None &&
+            slot.layerVersion == slot.window->getContentVersion()) {
+            appendLayer(slot);
+        }
+        else if (!slot.window->appendVertices(m_batch)) {
+            m_batch.flush();
+            target.draw(*slot.window);
+        }
+    }
+
+    m_batch.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::linkTop(sf::Uint32 index)
+{
+    auto& slot = m_slots[index];
+    slot.above = None;
+    slot.below = m_top;
+
+    if (m_top != None) {
+        m_slots[m_top].above = index;
+    }
+    else {
+        m_bottom = index;
+    }
+    m_top = index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::unlink(sf::Uint32 index)
+{
+    auto& slot = m_slots[index];
+
+    if (slot.above != None) {
+        m_slots[slot.above].below = slot.below;
+    }
+    else {
+        m_top = slot.below;
+    }
+
+    if (slot.below != None) {
+        m_slots[slot.below].above = slot.above;
+    }
+    else {
+        m_bottom = slot.above;
+    }
+
+    slot.above = None;
+    slot.below = None;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::processRemovals()
+{
+    for (auto id : m_removals) {
+        auto& slot = m_slots[id.index];
+
+        auto it = m_tags.find(slot.window->tag);
+        if (it != m_tags.end() && it->second == id) {
+            m_tags.erase(it);
+        }
+
+        if (Window::focus == id) {
+            Window::focus = WindowId();
+        }
+
+        unlink(id.index);
+        m_atlas.release(slot.layer);
+        slot.layerVersion = 0;
+        slot.window.reset();
+        slot.removing = false;
+        ++slot.generation;
+        m_freeSlots.push_back(id.index);
+    }
+
+    m_removals.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::rebuildIndex()
+{
+    m_index.create(State::get().frameSize);
+
+    for (auto index = m_bottom; index != None; index = m_slots[index].above) {
+        if (!m_slots[index].removing) {
+            auto window = m_slots[index].window.get();
+            m_index.insert(window, window->getBounds(), ++m_nextZ);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Window* WindowManager::getMouseTarget() const
+{
+    // A focused window (e.g. one being dragged) keeps the mouse even if the
+    // mouse has moved off of it
+    auto focused = getWindow(Window::focus);
+    if (focused) {
+        return focused;
+    }
+
+    return m_index.getTopmostAt(State::get().mousePosition);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void WindowManager::updateLayers()
+{
+    auto drawn = false;
+
+    for (auto index = m_bottom; index != None; index = m_slots[index].above) {
+        auto& slot = m_slots[index];
+        auto& window = *slot.window;
+        auto version = window.getContentVersion();
+
+        if (version == slot.layerVersion) {
+            continue;
+        }
+
+        slot.layerVersion = version;
+        if (!version) {
+            m_atlas.release(slot.layer);
+            continue;
+        }
+
+        // The layer holds the content as it is before the window's transform
+        auto bounds = window.getInverseTransform().transformRect(
+            window.getBounds());
+        auto size = sf::Vector2u(
+            static_cast<sf::Uint32>(std::ceil(bounds.width)),
+            static_cast<sf::Uint32>(std::ceil(bounds.height)));
+
+        if (!LayerAtlas::fits(slot.layer, size)) {
+            m_atlas.release(slot.layer);
+            slot.layer = m_atlas.allocate(size);
+        }
+
+        // Windows which do not fit in the atlas are drawn directly, and are
+        // not retried until their content changes
+        if (slot.layer.page == LayerAtlas::None) {
+            continue;
+        }
+        slot.layerBounds = bounds;
+
+        // Undo the transform the window applies to itself in draw()
+        sf::Transform transform;
+        transform.translate(-bounds.left, -bounds.top);
+        transform.combine(window.getInverseTransform());
+
+        m_atlas.beginDraw(slot.layer).draw(window, transform);
+        drawn = true;
+    }
+
+    if (drawn) {
+        m_atlas.endDraw();
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-std::vector<std::unique_ptr<Window>>::iterator WindowManager::getWindowIter(
-    const std::string& tag)
+void WindowManager::appendLayer(const Slot& slot) const
 {
-    auto tagsEqual = [tag](const auto& window) {
-        return window->tag == tag;
-    };
+    const auto& bounds = slot.layerBounds;
+    const auto& rect = slot.layer.rect;
+
+    auto transform = slot.window->getTransform();
+    transform.translate(bounds.left, bounds.top);
+
+    auto width = std::ceil(bounds.width);
+    auto height = std::ceil(bounds.height);
+    auto left = static_cast<float>(rect.left);
+    auto top = static_cast<float>(rect.top);
+
+    // Layers were blended onto transparent regions, so their colors are
+    // already multiplied by their alpha
+    auto& vertices = m_batch.getVertices(
+        &m_atlas.getTexture(slot.layer.page),
+        sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha));
 
-    return std::find_if(m_windows.begin(), m_windows.end(), tagsEqual);
+    vertices.emplace_back(transform.transformPoint(0.f, 0.f),
+                          sf::Vector2f(left, top));
+    vertices.emplace_back(transform.transformPoint(width, 0.f),
+                          sf::Vector2f(left + width, top));
+    vertices.emplace_back(transform.transformPoint(width, height),
+                          sf::Vector2f(left + width, top + height));
+    vertices.emplace_back(transform.transformPoint(0.f, height),
+                          sf::Vector2f(left, top + height));
 }
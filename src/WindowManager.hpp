@@ -11,13 +11,36 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include <SFML/Graphics.hpp>
 
 #include "Common.hpp"
 #include "Window.hpp"
+#include "LayerAtlas.hpp"
+#include "RenderBatch.hpp"
+#include "WindowIndex.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Manages the rendering of all active Windows
+///
+/// Windows live in stable slots addressed by WindowId, and are linked into
+/// a z-ordered list through their slots, so raising or removing a Window
+/// never shifts the others. Tags are mapped to WindowIds when a Window is
+/// added so that looking a Window up by tag is a single hash lookup. Windows
+/// are removed at the end of update() rather than immediately, so Windows
+/// may close themselves or others from within their own update().
+///
+/// The content of Windows which report a content version is rendered into a
+/// region of a LayerAtlas at the end of update() whenever the version has
+/// changed, and drawn from there as a single textured quad, so Windows which
+/// are only being moved are never redrawn. Layer quads and the geometry of
+/// Windows that can append it are drawn through a shared RenderBatch, so
+/// consecutive Windows using the same texture share a draw call. Every
+/// change to where or how a Window is drawn is reported to the State's
+/// FrameCompositor as damage.
 ///////////////////////////////////////////////////////////////////////////////
 class WindowManager : public sf::Drawable {
 public:
@@ -28,12 +51,19 @@ public:
     WindowManager() = default;
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Removes an open Window
+    /// @brief Removes an open Window at the end of the next update()
     ///
     /// @param tag  Tag of the Window to remove
     ///////////////////////////////////////////////////////////////////////////
     void remove(const std::string& tag);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Removes an open Window at the end of the next update()
+    ///
+    /// @param id   Handle of the Window to remove
+    ///////////////////////////////////////////////////////////////////////////
+    void remove(WindowId id);
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Moves a Window with a matching tag to the highest z-level
     ///
@@ -41,12 +71,39 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     void setHighest(const std::string& tag);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves a Window to the highest z-level
+    ///
+    /// @param id   Handle of the Window to move to ontop of all the others
+    ///////////////////////////////////////////////////////////////////////////
+    void setHighest(WindowId id);
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Adds a new Window to be managed
     ///
     /// @param window   The Window to be managed
+    ///
+    /// @return Handle of the Window
+    ///////////////////////////////////////////////////////////////////////////
+    WindowId addWindow(Window* window);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the handle of the open Window with a tag
+    ///
+    /// @param tag  Tag to search for
+    ///
+    /// @return Handle of the Window, or WindowId() if none has the tag
+    ///////////////////////////////////////////////////////////////////////////
+    WindowId find(const std::string& tag) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns an open Window
+    ///
+    /// @param id   Handle of the Window
+    ///
+    /// @return The Window, or nullptr if it has been removed
     ///////////////////////////////////////////////////////////////////////////
-    void addWindow(Window* window);
+    Window* getWindow(WindowId id) const;
 
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Updates all managed windows
@@ -57,6 +114,31 @@ public:
 
 private:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks the end of the z-ordered list / a slot index not in use
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr sf::Uint32 None = 0xFFFFFFFF;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief An open Window, its links in the z-ordered list and its layer
+    ///
+    /// bounds are the frame-space bounds the Window was last drawn with,
+    /// layerBounds are the bounds of the content before the Window's own
+    /// transform, and layerVersion is the content version last drawn into
+    /// the layer (0 if none).
+    ///////////////////////////////////////////////////////////////////////////
+    struct Slot {
+        std::unique_ptr<Window> window;
+        sf::Uint32 generation = 0;
+        sf::Uint32 above = None;
+        sf::Uint32 below = None;
+        bool removing = false;
+        sf::FloatRect bounds;
+        LayerAtlas::Region layer;
+        sf::FloatRect layerBounds;
+        sf::Uint64 layerVersion = 0;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Overloaded draw function from sf::Drawable/sf::Transformable
     ///
@@ -65,17 +147,62 @@ private:
     void draw(sf::RenderTarget& target, sf::RenderStates) const override;
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Tries to find a window with a matching tag and returns an iter
+    /// @brief Links a slot at the top of the z-ordered list
     ///
-    /// @param tag  Tag to search for
+    /// @param index    Index of the slot
+    ///////////////////////////////////////////////////////////////////////////
+    void linkTop(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Unlinks a slot from the z-ordered list
+    ///
+    /// @param index    Index of the slot
+    ///////////////////////////////////////////////////////////////////////////
+    void unlink(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Closes the Windows queued for removal and frees their slots
+    ///////////////////////////////////////////////////////////////////////////
+    void processRemovals();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Recreates the hit-testing index for the current frame size
+    ///////////////////////////////////////////////////////////////////////////
+    void rebuildIndex();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Redraws the layers of Windows whose content version changed
+    ///////////////////////////////////////////////////////////////////////////
+    void updateLayers();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Appends the quad drawing a Window from its layer to the batch
+    ///
+    /// @param slot     Slot of the Window, whose layer must be up to date
+    ///////////////////////////////////////////////////////////////////////////
+    void appendLayer(const Slot& slot) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the window which should receive the mouse this frame
     ///
-    /// @return An iterator pointing to the matching window, or m_windows.end()
+    /// @return The focused window if there is one, otherwise the topmost
+    ///         window under the mouse, or nullptr
     ///////////////////////////////////////////////////////////////////////////
-    std::vector<std::unique_ptr<Window>>::iterator getWindowIter(
-        const std::string& tag);
+    const Window* getMouseTarget() const;
 
     ///////////////////////////////////////////////////////////////////////////
-    std::vector<std::unique_ptr<Window>> m_windows;
+    std::vector<Slot> m_slots;
+    std::vector<sf::Uint32> m_freeSlots;
+    std::vector<WindowId> m_removals;
+    std::vector<Window*> m_updateOrder;
+    std::unordered_map<std::string, WindowId> m_tags;
+    sf::Uint32 m_top = None;
+    sf::Uint32 m_bottom = None;
+    WindowIndex m_index;
+    LayerAtlas m_atlas;
+    // Only holds the vertex buffer, which is reused across frames
+    mutable RenderBatch m_batch;
+    sf::Uint64 m_nextZ = 0;
 };
 
 #endif
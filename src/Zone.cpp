@@ -10,6 +10,10 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
 #include "State.hpp"
 
 // TODO: Implement a way for Zones to be very, very large without running out
@@ -25,94 +29,94 @@ Zone::Zone() : m_map(State::get().font, {50, 50}, {28, 28}, 32)
 {
     name = "default";
 
-    if (!m_mapBuffer.create(
-        m_map.getArea().x * m_map.getSpacing().y,
-        m_map.getArea().y * m_map.getSpacing().y)) {
-        log_exit("Zone map buffer creation failed");
+    // Even constructing the map buffer needs a display
+    if (!State::get().headless) {
+        m_mapBuffer = std::make_unique<sf::RenderTexture>();
+        if (!m_mapBuffer->create(m_map.getArea().x * m_map.getSpacing().x,
+                                 m_map.getArea().y * m_map.getSpacing().y)) {
+            log_exit("Zone map buffer creation failed");
+        }
     }
 
+    auto area = m_map.getArea();
+    m_terrain.resize(area.x * area.y);
+    m_dirtyFlags.assign(area.x * area.y, 0);
+    m_lightMap.create(area);
+    m_lightMap.setAmbient(sf::Color(40, 40, 48));
+    m_spatialIndex.create(area);
+
     // TODO: Reomve
-    for (sf::Uint32 x = 0; x < m_map.getArea().x; ++x) {
-        for (sf::Uint32 y = 0; y < m_map.getArea().y; ++y) {
+    auto& random = State::get().random;
+    auto randomColor = [&random](int r, int g, int b, int spread) {
+        return sf::Color(
+            static_cast<sf::Uint8>(random.between(r, r + spread - 1)),
+            static_cast<sf::Uint8>(random.between(g, g + spread - 1)),
+            static_cast<sf::Uint8>(random.between(b, b + spread - 1))
+        );
+    };
+
+    for (sf::Uint32 x = 0; x < area.x; ++x) {
+        for (sf::Uint32 y = 0; y < area.y; ++y) {
             m_map.setTile({x, y}, GlyphTileMap::Tile());
-            if (x == m_map.getArea().x - 1 ||
-                x == 0 ||
-                y == m_map.getArea().y - 1 ||
-                y == 0) {
-                if (rand() % 2 == 0) {
-                    m_map.setTileCharacter({x, y}, '#');
-                }
-                else {
-                    m_map.setTileCharacter({x, y}, '=');
-                }
-                m_map.setTileFgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
-                m_map.setTileBgColor({x, y}, sf::Color(
-                    rand() % 20 + 50,
-                    rand() % 10 + 50,
-                    rand() % 5 + 50
-                ));
-            }
-            else if (rand() % 5 == 0) {
-                if (rand() % 2 == 0) {
-                    m_map.setTileCharacter({x, y}, '#');
-                }
-                else {
-                    m_map.setTileCharacter({x, y}, '=');
-                }
-                m_map.setTileFgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
-                m_map.setTileBgColor({x, y}, sf::Color(
-                    rand() % 20 + 50,
-                    rand() % 10 + 50,
-                    rand() % 5 + 50
-                ));
+
+            Terrain terrain;
+            terrain.foreground = randomColor(30, 10, 5, 5);
+            terrain.opaque = false;
+
+            if (x == area.x - 1 || x == 0 || y == area.y - 1 || y == 0 ||
+                random.below(5) == 0) {
+                terrain.character = random.below(2) == 0 ? '#' : '=';
+                terrain.background = sf::Color(
+                    static_cast<sf::Uint8>(random.between(50, 69)),
+                    static_cast<sf::Uint8>(random.between(50, 59)),
+                    static_cast<sf::Uint8>(random.between(50, 54))
+                );
+                terrain.opaque = true;
             }
-            else if (rand() % 3 == 0) {
-                m_map.setTileCharacter({x, y}, ',');
-                m_map.setTileFgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
-                m_map.setTileBgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
+            else if (random.below(3) == 0) {
+                terrain.character = ',';
+                terrain.background = randomColor(30, 10, 5, 5);
             }
-            else if (rand() % 3 == 0) {
-                m_map.setTileCharacter({x, y}, '.');
-                m_map.setTileFgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
-                m_map.setTileBgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
+            else if (random.below(3) == 0) {
+                terrain.character = '.';
+                terrain.background = randomColor(30, 10, 5, 5);
             }
             else {
-                m_map.setTileCharacter({x, y}, ' ');
-                m_map.setTileFgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
-                m_map.setTileBgColor({x, y}, sf::Color(
-                    rand() % 5 + 30,
-                    rand() % 5 + 10,
-                    rand() % 5 + 5
-                ));
+                terrain.character = ' ';
+                terrain.background = randomColor(30, 10, 5, 5);
             }
+
+            setTerrain({x, y}, terrain);
+        }
+    }
+
+    for (sf::Uint32 i = 0; i < (area.x * area.y) / 200; ++i) {
+        sf::Vector2u coord(random.below(area.x), random.below(area.y));
+
+        if (!getTerrain(coord).opaque) {
+            m_torches.push_back(m_lightMap.addLight({
+                coord, sf::Color(255, 160, 80), 7, 255
+            }));
+        }
+    }
+
+    // The player starts on the floor tile closest to the center
+    sf::Vector2u start(area.x / 2, area.y / 2);
+    while (getTerrain(start).opaque) {
+        start.x = (start.x + 1) % area.x;
+        start.y += start.x == 0 ? 1 : 0;
+    }
+    m_player = spawn(start, Glyph{'@', sf::Color::White}, Actor());
+
+    for (sf::Uint32 i = 0; i < (area.x * area.y) / 50; ++i) {
+        sf::Vector2i coord(static_cast<int>(random.below(area.x)),
+                           static_cast<int>(random.below(area.y)));
+
+        if (isWalkable(coord)) {
+            spawn(sf::Vector2u(coord),
+                  Glyph{'r', randomColor(150, 110, 90, 60)},
+                  Actor{random.below(60) + 70},
+                  Brain());
         }
     }
     // TODO: ^
@@ -125,14 +129,27 @@ Zone::Zone() : m_map(State::get().font, {50, 50}, {28, 28}, 32)
     );
     m_mapSection.left -= m_mapSection.width / 2;
     m_mapSection.top -= m_mapSection.height / 2;
+    m_lastMapSection = m_mapSection;
+    m_drawSection = m_mapSection;
 
-    m_mapBuffer.draw(m_map);
-    m_mapBuffer.display();
+    if (!State::get().headless) {
+        m_mapBuffer->clear();
+    }
+    m_lightMap.update();
+    composeTiles();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 void Zone::update()
 {
+    m_lastMapSection = m_mapSection;
+
+    // The map's extent, rather than the map buffer's, so that headless games
+    // scroll as far as those with a window
+    auto area = m_map.getArea();
+    auto spacing = m_map.getSpacing();
+    sf::Vector2i extent(sf::Vector2u(area.x * spacing.x, area.y * spacing.y));
+
     // Mouse is near right edge
     if (State::get().mousePosition.x + m_scrollThreshold >=
         static_cast<int>(State::get().frameSize.x) ||
@@ -140,8 +157,7 @@ void Zone::update()
 
         // And the map section has room to move
         if (m_mapSection.left + m_mapSection.width <=
-            static_cast<int>(m_mapBuffer.getSize().x) - m_scrollSpeed +
-            m_mapPadding) {
+            extent.x - m_scrollSpeed + m_mapPadding) {
             m_mapSection.left += m_scrollSpeed;
         }
     }
@@ -162,8 +178,7 @@ void Zone::update()
 
         // And the map section has room to move
         if (m_mapSection.top + m_mapSection.height <=
-            static_cast<int>(m_mapBuffer.getSize().y) -
-            m_scrollSpeed + m_mapPadding) {
+            extent.y - m_scrollSpeed + m_mapPadding) {
             m_mapSection.top += m_scrollSpeed;
 
         }
@@ -177,12 +192,45 @@ void Zone::update()
             m_mapSection.top -= m_scrollSpeed;
         }
     }
+
+    flickerTorches();
+    readPlayerInput();
+    runTurns();
+
+    if (getViewTiles() != m_promotedView) {
+        promoteActors();
+    }
+    m_lightMap.update();
+    composeTiles();
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::interpolate(float alpha)
+{
+    auto lerp = [alpha](int from, int to) {
+        return from + static_cast<int>(
+            std::round(static_cast<float>(to - from) * alpha));
+    };
+
+    // Whole pixels keep the glyphs sharp
+    sf::IntRect section(lerp(m_lastMapSection.left, m_mapSection.left),
+                        lerp(m_lastMapSection.top, m_mapSection.top),
+                        m_mapSection.width, m_mapSection.height);
+
+    // Scrolling moves everything drawn from the map buffer, and tile damage
+    // is placed relative to m_mapSection, so redraw it all while scrolling
+    if (section != m_drawSection || m_lastMapSection != m_mapSection) {
+        State::get().frameCompositor.damageAll();
+    }
+    m_drawSection = section;
 }
 
 ///////////////////////////////////////////////////////////////////////////
 void Zone::setMapSection(const sf::IntRect& section)
 {
     m_mapSection = section;
+    m_lastMapSection = m_mapSection;
+    State::get().frameCompositor.damageAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -190,6 +238,8 @@ void Zone::setMapSectionToFrameSize()
 {
     m_mapSection.width = static_cast<int>(State::get().frameSize.x);
     m_mapSection.height = static_cast<int>(State::get().frameSize.y);
+    m_lastMapSection = m_mapSection;
+    State::get().frameCompositor.damageAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -197,6 +247,8 @@ void Zone::setMapSectionCenter(const sf::Vector2i& center)
 {
     m_mapSection.left = center.x - (m_mapSection.width / 2);
     m_mapSection.top = center.y - (m_mapSection.height / 2);
+    m_lastMapSection = m_mapSection;
+    State::get().frameCompositor.damageAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -210,12 +262,436 @@ void Zone::moveMapSection(const sf::Vector2i& delta)
 {
     m_mapSection.left += delta.x;
     m_mapSection.top += delta.y;
+    m_lastMapSection = m_mapSection;
+    State::get().frameCompositor.damageAll();
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::setTerrain(const sf::Vector2u& coord, const Terrain& terrain)
+{
+    auto index = getIndex(coord);
+
+    m_terrain[index] = terrain;
+    m_lightMap.setOpaque(coord, terrain.opaque);
+    markDirty(index);
+}
+
+///////////////////////////////////////////////////////////////////////////
+const Zone::Terrain& Zone::getTerrain(const sf::Vector2u& coord) const
+{
+    return m_terrain[getIndex(coord)];
+}
+
+///////////////////////////////////////////////////////////////////////////
+LightMap& Zone::getLightMap()
+{
+    return m_lightMap;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::moveEntity(Entity entity, const sf::Vector2u& coord)
+{
+    auto& position = m_entities.get<Position>(entity);
+
+    if (position.coord == coord) {
+        return;
+    }
+
+    markDirty(getIndex(position.coord));
+    markDirty(getIndex(coord));
+    position.coord = coord;
+    m_spatialIndex.move(entity, coord);
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::destroyEntity(Entity entity)
+{
+    if (m_scheduler.isScheduled(entity)) {
+        m_scheduler.unschedule(entity);
+    }
+    markDirty(getIndex(m_entities.get<Position>(entity).coord));
+    m_spatialIndex.remove(entity);
+    m_entities.destroy(entity);
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::refreshEntity(Entity entity)
+{
+    markDirty(getIndex(m_entities.get<Position>(entity).coord));
+}
+
+///////////////////////////////////////////////////////////////////////////
+EntityStore& Zone::getEntities()
+{
+    return m_entities;
+}
+
+///////////////////////////////////////////////////////////////////////////
+const SpatialIndex& Zone::getSpatialIndex() const
+{
+    return m_spatialIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////
+const TurnScheduler& Zone::getScheduler() const
+{
+    return m_scheduler;
+}
+
+///////////////////////////////////////////////////////////////////////////
+Entity Zone::getPlayer() const
+{
+    return m_player;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::rest(sf::Uint32 turns)
+{
+    m_restTurns = turns;
+}
+
+///////////////////////////////////////////////////////////////////////////
+sf::Uint32 Zone::getIndex(const sf::Vector2u& coord) const
+{
+    return (coord.y * m_map.getArea().x) + coord.x;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::markDirty(sf::Uint32 index)
+{
+    if (!m_dirtyFlags[index]) {
+        m_dirtyFlags[index] = 1;
+        m_dirtyTiles.push_back(index);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::composeTiles()
+{
+    for (auto index : m_lightMap.getDirtyTiles()) {
+        markDirty(index);
+    }
+    m_lightMap.clearDirtyTiles();
+
+    if (m_dirtyTiles.empty()) {
+        return;
+    }
+
+    auto width = m_map.getArea().x;
+    for (auto index : m_dirtyTiles) {
+        sf::Vector2u coord(index % width, index / width);
+        const auto& terrain = m_terrain[index];
+
+        // The topmost entity with a Glyph is drawn over the terrain
+        auto character = terrain.character;
+        auto foreground = terrain.foreground;
+        bool covered = false;
+
+        m_spatialIndex.forEachAt(coord, [&](Entity entity) {
+            if (!covered && m_entities.has<Glyph>(entity)) {
+                const auto& glyph = m_entities.get<Glyph>(entity);
+                character = glyph.character;
+                foreground = glyph.color;
+                covered = true;
+            }
+        });
+
+        if (m_map.getTile(coord).character != character) {
+            m_map.setTileCharacter(coord, character);
+        }
+        m_map.setTileFgColor(coord, m_lightMap.shade(index, foreground));
+        m_map.setTileBgColor(coord,
+                             m_lightMap.shade(index, terrain.background));
+        m_dirtyFlags[index] = 0;
+    }
+
+    if (State::get().headless) {
+        m_dirtyTiles.clear();
+        return;
+    }
+
+    // Characters may overhang their tiles, so each dirty tile is redrawn
+    // along with the overhang, which repaints every tile reaching into it
+    // from scratch. Later regions repaint where they overlap earlier ones.
+    m_redrawBatch.clear();
+
+    auto spacing = sf::Vector2i(m_map.getSpacing());
+    auto overhang = static_cast<int>(m_map.getOverhang());
+    for (auto index : m_dirtyTiles) {
+        sf::IntRect region(
+            static_cast<int>(index % width) * spacing.x - overhang,
+            static_cast<int>(index / width) * spacing.y - overhang,
+            spacing.x + overhang * 2,
+            spacing.y + overhang * 2);
+        m_map.appendRegion(sf::FloatRect(region), m_redrawBatch);
+
+        // Tiles outside of the map section are clipped away
+        region.left -= m_mapSection.left;
+        region.top -= m_mapSection.top;
+        State::get().frameCompositor.addDamage(region);
+    }
+    m_dirtyTiles.clear();
+
+    State::get().renderStats.draw(*m_mapBuffer, m_redrawBatch.data(),
+                                  m_redrawBatch.size(), sf::Quads,
+                                  sf::RenderStates(&m_map.getTexture()));
+    m_mapBuffer->display();
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::flickerTorches()
+{
+    if ((m_flickerAcc += State::get().deltaMs) < 80) {
+        return;
+    }
+    m_flickerAcc = 0;
+
+    for (auto torch : m_torches) {
+        m_lightMap.setLightIntensity(
+            torch,
+            static_cast<sf::Uint8>(State::get().random.between(200, 255)));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+TurnScheduler::Time Zone::getActionDelay(Entity entity) const
+{
+    auto speed = std::max(m_entities.get<Actor>(entity).speed, 1u);
+    auto delay = (TurnScheduler::TurnLength * Actor::NormalSpeed) / speed;
+
+    // Actors simulated at a lower tier take one turn per several turns
+    if (m_entities.has<Brain>(entity)) {
+        switch (m_entities.get<Brain>(entity).tier) {
+            case Brain::Tier::Nearby:
+                delay *= NearbyPeriod;
+                break;
+            case Brain::Tier::Distant:
+                delay *= DistantPeriod;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return std::min(delay, TurnScheduler::MaxDelay);
+}
+
+///////////////////////////////////////////////////////////////////////////
+Brain::Tier Zone::getTier(const sf::Vector2u& coord) const
+{
+    if (getViewTiles().contains(sf::Vector2i(coord))) {
+        return Brain::Tier::Active;
+    }
+
+    auto player = sf::Vector2i(m_entities.get<Position>(m_player).coord);
+    auto range = std::max(std::abs(static_cast<int>(coord.x) - player.x),
+                          std::abs(static_cast<int>(coord.y) - player.y));
+
+    return range <= ActiveRange ? Brain::Tier::Active
+         : range <= NearbyRange ? Brain::Tier::Nearby
+         : Brain::Tier::Distant;
+}
+
+///////////////////////////////////////////////////////////////////////////
+sf::IntRect Zone::getViewTiles() const
+{
+    auto spacing = sf::Vector2i(m_map.getSpacing());
+
+    auto left = m_mapSection.left / spacing.x;
+    auto top = m_mapSection.top / spacing.y;
+    auto right = (m_mapSection.left + m_mapSection.width + spacing.x - 1)
+                 / spacing.x;
+    auto bottom = (m_mapSection.top + m_mapSection.height + spacing.y - 1)
+                  / spacing.y;
+
+    return {left, top, right - left, bottom - top};
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::promoteActors()
+{
+    auto promote = [this](Entity entity) {
+        if (!m_entities.has<Brain>(entity)) {
+            return;
+        }
+
+        auto& brain = m_entities.get<Brain>(entity);
+        if (brain.tier == Brain::Tier::Active) {
+            return;
+        }
+        brain.tier = Brain::Tier::Active;
+
+        // Bring the next turn forward rather than let the actor sit idle
+        // for the rest of its coarse turn
+        auto delay = getActionDelay(entity);
+        if (m_scheduler.getScheduledTime(entity) >
+            m_scheduler.getTime() + delay) {
+            m_scheduler.schedule(entity, delay);
+        }
+    };
+
+    m_promotedView = getViewTiles();
+    m_promotedCoord = m_entities.get<Position>(m_player).coord;
+
+    auto player = sf::Vector2i(m_promotedCoord);
+    m_spatialIndex.forEachInRect(m_promotedView, promote);
+    m_spatialIndex.forEachInRect({player.x - ActiveRange,
+                                  player.y - ActiveRange,
+                                  (2 * ActiveRange) + 1,
+                                  (2 * ActiveRange) + 1}, promote);
+}
+
+///////////////////////////////////////////////////////////////////////////
+bool Zone::isWalkable(const sf::Vector2i& coord) const
+{
+    auto area = m_map.getArea();
+
+    if (coord.x < 0 || coord.y < 0 ||
+        coord.x >= static_cast<int>(area.x) ||
+        coord.y >= static_cast<int>(area.y)) {
+        return false;
+    }
+
+    sf::Vector2u tile(coord);
+    return !getTerrain(tile).opaque && !m_spatialIndex.isOccupied(tile);
+}
+
+///////////////////////////////////////////////////////////////////////////
+bool Zone::stepEntity(Entity entity, const sf::Vector2i& step)
+{
+    auto coord = sf::Vector2i(m_entities.get<Position>(entity).coord) + step;
+
+    if (!isWalkable(coord)) {
+        return false;
+    }
+
+    moveEntity(entity, sf::Vector2u(coord));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::readPlayerInput()
+{
+    static const std::pair<Key, sf::Vector2i> steps[] = {
+        {Key::H, {-1, 0}}, {Key::J, {0, 1}}, {Key::K, {0, -1}},
+        {Key::L, {1, 0}}, {Key::Y, {-1, -1}}, {Key::U, {1, -1}},
+        {Key::B, {-1, 1}}, {Key::N, {1, 1}}
+    };
+
+    for (const auto& step : steps) {
+        if (State::get().getKeyPressedStatus(step.first)) {
+            m_playerStep = step.second;
+        }
+    }
+
+    if (State::get().getKeyPressedStatus(Key::Space)) {
+        m_playerWaits = true;
+    }
+    else if (State::get().getKeyPressedStatus(Key::Z)) {
+        rest(1000);
+        State::get().messageLog.push("You begin resting.");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+bool Zone::takePlayerTurn()
+{
+    if (m_playerStep != sf::Vector2i(0, 0)) {
+        if (!stepEntity(m_player, m_playerStep)) {
+            State::get().messageLog.push("Something blocks your way.",
+                                         sf::Color(160, 160, 160));
+        }
+        m_playerStep = {0, 0};
+    }
+    else if (m_playerWaits) {
+        m_playerWaits = false;
+    }
+    else if (m_restTurns) {
+        if (!--m_restTurns) {
+            State::get().messageLog.push("You feel rested.");
+        }
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::takeActorTurn(Entity entity)
+{
+    // Coarser actors make up for the turns they skip by wandering as far
+    // in a single action, which is still walked a tile at a time so that
+    // they end up only where an actor acting every turn could have
+    int reach = 1;
+    if (m_entities.has<Brain>(entity)) {
+        switch (m_entities.get<Brain>(entity).tier) {
+            case Brain::Tier::Nearby:
+                reach = NearbyReach;
+                break;
+            case Brain::Tier::Distant:
+                reach = DistantReach;
+                break;
+            default:
+                break;
+        }
+    }
+
+    auto& random = State::get().random;
+    sf::Vector2i target(random.between(-reach, reach),
+                        random.between(-reach, reach));
+
+    // Each step along the line to the target moves at most a tile on each
+    // axis, and the walk stops at the first tile which isn't walkable
+    auto steps = std::max(std::abs(target.x), std::abs(target.y));
+    sf::Vector2i walked(0, 0);
+    for (int i = 1; i <= steps; ++i) {
+        sf::Vector2i next(target.x * i / steps, target.y * i / steps);
+        if (!stepEntity(entity, next - walked)) {
+            break;
+        }
+        walked = next;
+    }
+
+    // Tiers are only lowered here, as the actor acts, so that actors which
+    // leave the player's surroundings are demoted without any searching
+    if (m_entities.has<Brain>(entity)) {
+        m_entities.get<Brain>(entity).tier =
+            getTier(m_entities.get<Position>(entity).coord);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+void Zone::runTurns()
+{
+    // Resting runs through every one of its turns here, in a tight loop.
+    // Capping the turns per frame would only spread the same work over many
+    // frames, so resting would take far longer than the turns themselves.
+    while (!m_scheduler.empty()) {
+        // Turns stop at the player until they have queued an action
+        if (m_scheduler.peek() == m_player && !takePlayerTurn()) {
+            break;
+        }
+
+        auto entity = m_scheduler.next();
+        if (entity != m_player) {
+            takeActorTurn(entity);
+        }
+        m_scheduler.schedule(entity, getActionDelay(entity));
+
+        // Actors the player moved near must start acting every turn
+        if (entity == m_player &&
+            m_entities.get<Position>(m_player).coord != m_promotedCoord) {
+            promoteActors();
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////
 void Zone::draw(sf::RenderTarget& target, sf::RenderStates) const
 {
-    sf::Sprite mapSprite(m_mapBuffer.getTexture());
-    mapSprite.setTextureRect(m_mapSection);
-    target.draw(mapSprite);
+    sf::Sprite mapSprite(m_mapBuffer->getTexture());
+    mapSprite.setTextureRect(m_drawSection);
+    State::get().renderStats.draw(target, mapSprite);
 }
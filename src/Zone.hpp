@@ -11,11 +11,17 @@
 /// Headers
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <SFML/Graphics.hpp>
 
+#include "LightMap.hpp"
+#include "Components.hpp"
+#include "EntityStore.hpp"
 #include "GlyphTileMap.hpp"
+#include "SpatialIndex.hpp"
+#include "TurnScheduler.hpp"
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief  Class describing a discreet area within the game world
@@ -23,6 +29,17 @@
 class Zone : public sf::Drawable {
 public:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @struct Zone::Terrain
+    /// @brief  Unlit appearance and properties of a single tile of a Zone
+    ///////////////////////////////////////////////////////////////////////////
+    struct Terrain {
+        sf::Uint32 character;
+        sf::Color foreground;
+        sf::Color background;
+        bool opaque;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief TODO: Disable default constructor
     ///////////////////////////////////////////////////////////////////////////
@@ -39,10 +56,23 @@ public:
     void operator=(const Zone&) = delete;
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Updates internal state, should be called once per frame
+    /// @brief Updates internal state, should be called once per simulation
+    ///        step
     ///////////////////////////////////////////////////////////////////////////
     void update();
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Places the drawn map section between the last two steps
+    ///
+    /// Scrolling moves the map section by whole steps, so drawing it where it
+    /// would be between them keeps scrolling smooth whatever the frame rate.
+    /// This should be called once per rendered frame.
+    ///
+    /// @param alpha    How far the frame is from the last step to the next,
+    ///                 in [0, 1)
+    ///////////////////////////////////////////////////////////////////////////
+    void interpolate(float alpha);
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Sets the section of the map to render
     ///
@@ -76,25 +106,294 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     void moveMapSection(const sf::Vector2i& delta);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Updates the terrain at a coord
+    ///
+    /// The tile is re-lit and redrawn on the next update().
+    ///
+    /// @param coord    Coordinate of the tile to update
+    /// @param terrain  New terrain for the tile
+    ///////////////////////////////////////////////////////////////////////////
+    void setTerrain(const sf::Vector2u& coord, const Terrain& terrain);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the terrain at a coord
+    ///
+    /// @param coord    Coordinate of the tile
+    ///
+    /// @return The terrain at coord
+    ///////////////////////////////////////////////////////////////////////////
+    const Terrain& getTerrain(const sf::Vector2u& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the LightMap used to light the Zone
+    ///
+    /// Changes made through the returned reference are applied to the Zone
+    /// on the next update().
+    ///
+    /// @return The LightMap used to light the Zone
+    ///////////////////////////////////////////////////////////////////////////
+    LightMap& getLightMap();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates a new entity at a coord
+    ///
+    /// Entities with an Actor component are scheduled to take turns.
+    ///
+    /// @param coord        Coordinate to create the entity at
+    /// @param components   Components of the entity besides its Position
+    ///
+    /// @return Handle to the new entity
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename... Components>
+    Entity spawn(const sf::Vector2u& coord, Components&&... components);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves an entity to a new coord
+    ///
+    /// @param entity   Handle of the entity to move
+    /// @param coord    New coordinate of the entity
+    ///////////////////////////////////////////////////////////////////////////
+    void moveEntity(Entity entity, const sf::Vector2u& coord);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Destroys an entity
+    ///
+    /// @param entity   Handle of the entity to destroy
+    ///////////////////////////////////////////////////////////////////////////
+    void destroyEntity(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Redraws the tile of an entity, call after changing its Glyph
+    ///
+    /// @param entity   Handle of the entity to redraw
+    ///////////////////////////////////////////////////////////////////////////
+    void refreshEntity(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the EntityStore holding the Zone's entities
+    ///
+    /// Use spawn(), moveEntity() and destroyEntity() rather than the store
+    /// directly to create, move or destroy entities.
+    ///
+    /// @return The EntityStore holding the Zone's entities
+    ///////////////////////////////////////////////////////////////////////////
+    EntityStore& getEntities();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of which entities occupy which tiles
+    ///
+    /// @return The index of which entities occupy which tiles
+    ///////////////////////////////////////////////////////////////////////////
+    const SpatialIndex& getSpatialIndex() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the scheduler deciding which actor acts next
+    ///
+    /// @return The scheduler deciding which actor acts next
+    ///////////////////////////////////////////////////////////////////////////
+    const TurnScheduler& getScheduler() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the entity controlled by the player
+    ///
+    /// @return Handle of the player entity
+    ///////////////////////////////////////////////////////////////////////////
+    Entity getPlayer() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Has the player rest for a number of turns
+    ///
+    /// The turns are all run on the next update(), as nothing stops them
+    /// partway.
+    ///
+    /// @param turns    Number of turns to rest, 0 to stop resting
+    ///////////////////////////////////////////////////////////////////////////
+    void rest(sf::Uint32 turns);
+
     ///////////////////////////////////////////////////////////////////////////
 
     std::string name;
 
 private:
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Range (in tiles) from the player within which actors are
+    ///        Active, and beyond which they are Distant rather than Nearby
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr int ActiveRange = 8;
+    static constexpr int NearbyRange = 24;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Number of turns a Nearby / Distant actor's action stands for
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr TurnScheduler::Time NearbyPeriod = 4;
+    static constexpr TurnScheduler::Time DistantPeriod = 16;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Most tiles a Nearby / Distant actor wanders in one action
+    ///
+    /// A random walk strays about the square root of its number of steps,
+    /// so this is about as far as the steps of the turns skipped would have
+    /// taken the actor. The tiles are walked one by one, up to the first
+    /// which blocks the way.
+    ///////////////////////////////////////////////////////////////////////////
+    static constexpr int NearbyReach = 2;
+    static constexpr int DistantReach = 4;
+
     ///////////////////////////////////////////////////////////////////////////
     /// @brief Overloaded draw function from sf::Drawable
     ///////////////////////////////////////////////////////////////////////////
     void draw(sf::RenderTarget& target, sf::RenderStates) const override;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Marks a tile to be re-lit and redrawn by composeTiles()
+    ///
+    /// @param index    Index of the tile
+    ///////////////////////////////////////////////////////////////////////////
+    void markDirty(sf::Uint32 index);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Writes the lit appearance of all dirty tiles into the map and
+    ///        redraws just those tiles, and their characters' overhang, into
+    ///        the map buffer
+    ///////////////////////////////////////////////////////////////////////////
+    void composeTiles();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the tile at a coord
+    ///
+    /// @param coord    Coordinate of the tile
+    ///
+    /// @return Index of the tile
+    ///////////////////////////////////////////////////////////////////////////
+    sf::Uint32 getIndex(const sf::Vector2u& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of ticks an action takes an actor
+    ///
+    /// @param entity   Handle of the actor
+    ///
+    /// @return Ticks until the actor's next turn
+    ///////////////////////////////////////////////////////////////////////////
+    TurnScheduler::Time getActionDelay(Entity entity) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the tier an actor at a coord should be simulated at
+    ///
+    /// @param coord    Coordinate of the actor
+    ///
+    /// @return Active if the coord is in view or near the player, Nearby or
+    ///         Distant otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    Brain::Tier getTier(const sf::Vector2u& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns the tiles covered by the map section
+    ///
+    /// @return Rectangle of tiles in view
+    ///////////////////////////////////////////////////////////////////////////
+    sf::IntRect getViewTiles() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Makes every actor in view or near the player Active, moving
+    ///        their next turn forward if it is further away than an Active
+    ///        actor's would be
+    ///////////////////////////////////////////////////////////////////////////
+    void promoteActors();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Returns whether or not an entity may step onto a coord
+    ///
+    /// @param coord    Coordinate to step onto
+    ///
+    /// @return True if the coord is in the Zone, transparent and unoccupied
+    ///////////////////////////////////////////////////////////////////////////
+    bool isWalkable(const sf::Vector2i& coord) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Moves an entity by an offset if the destination is walkable
+    ///
+    /// @param entity   Handle of the entity to move
+    /// @param step     Offset of the destination from the entity
+    ///
+    /// @return True if the entity moved
+    ///////////////////////////////////////////////////////////////////////////
+    bool stepEntity(Entity entity, const sf::Vector2i& step);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Queues the player's next action from the keys pressed this frame
+    ///////////////////////////////////////////////////////////////////////////
+    void readPlayerInput();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Performs the player's queued action
+    ///
+    /// @return False if the player has no queued action, true otherwise
+    ///////////////////////////////////////////////////////////////////////////
+    bool takePlayerTurn();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Performs the action of an actor not controlled by the player
+    ///
+    /// @param entity   Handle of the actor
+    ///////////////////////////////////////////////////////////////////////////
+    void takeActorTurn(Entity entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Runs turns until the player must act
+    ///////////////////////////////////////////////////////////////////////////
+    void runTurns();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Randomly varies the intensity of the torches
+    ///////////////////////////////////////////////////////////////////////////
+    void flickerTorches();
+
     GlyphTileMap m_map;
+    LightMap m_lightMap;
+    std::vector<Terrain> m_terrain;
+    std::vector<sf::Uint8> m_dirtyFlags;
+    std::vector<sf::Uint32> m_dirtyTiles;
+    std::vector<sf::Vertex> m_redrawBatch;
+    sf::Int32 m_flickerAcc = 0;
+    std::vector<LightMap::LightId> m_torches;
+    EntityStore m_entities;
+    SpatialIndex m_spatialIndex;
+    TurnScheduler m_scheduler;
+    Entity m_player = {0, 0};
+    sf::Vector2i m_playerStep;
+    bool m_playerWaits = false;
+    sf::Uint32 m_restTurns = 0;
+    sf::IntRect m_promotedView;
+    sf::Vector2u m_promotedCoord;
     int m_mapPadding = 0;
     int m_scrollSpeed = 3;
     sf::IntRect m_mapSection;
+    sf::IntRect m_lastMapSection;
+    sf::IntRect m_drawSection;
     int m_scrollThreshold = 5;
-    sf::RenderTexture m_mapBuffer;
+    std::unique_ptr<sf::RenderTexture> m_mapBuffer;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
+/// Template implementation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename... Components>
+Entity Zone::spawn(const sf::Vector2u& coord, Components&&... components)
+{
+    auto entity = m_entities.create(Position{coord},
+                                    std::forward<Components>(components)...);
+    m_spatialIndex.insert(entity, coord);
+    markDirty(getIndex(coord));
+
+    if (m_entities.has<Actor>(entity)) {
+        m_scheduler.schedule(entity, getActionDelay(entity));
+    }
+
+    return entity;
+}
 
 #endif
@@ -47,6 +47,15 @@ void ZoneManager::update()
     }
 }
 
+///////////////////////////////////////////////////////////////////////////
+void ZoneManager::interpolate(float alpha)
+{
+    auto it = m_zones.find(m_currentZone);
+    if (it != m_zones.end()) {
+        (*it).second->interpolate(alpha);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 void ZoneManager::draw(sf::RenderTarget& target, sf::RenderStates) const
 {
@@ -41,10 +41,18 @@ public:
     void setCurrentZone(const std::string& name);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// @brief Updates internal state, should be called once per frame
+    /// @brief Updates internal state, should be called once per simulation
+    ///        step
     ///////////////////////////////////////////////////////////////////////////
     void update();
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Interpolates the current Zone for the frame being rendered
+    ///
+    /// @param alpha    How far the frame is from the last step to the next
+    ///////////////////////////////////////////////////////////////////////////
+    void interpolate(float alpha);
+
 private:
 
     ///////////////////////////////////////////////////////////////////////////